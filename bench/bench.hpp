@@ -0,0 +1,45 @@
+#ifndef JSON_BACKBONE_BENCH_HEADER
+#define JSON_BACKBONE_BENCH_HEADER
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace bench {
+
+// Prevents the compiler from optimizing a value away
+template <class T>
+inline void do_not_optimize(T const& value) {
+#if defined(__GNUC__)
+  asm volatile("" : : "g"(&value) : "memory");
+#else
+  static volatile char const* sink;
+  sink = reinterpret_cast<char const volatile*>(&value);
+#endif
+}
+
+//
+// measure runs func and prints the time spent per operation
+//
+// func must return the number of operations it executed.
+//
+template <class Func>
+double measure(std::string const& name, Func&& func, std::size_t repeat = 5) {
+  double best = 0.;
+  for (std::size_t run = 0; run < repeat; ++run) {
+    auto start = std::chrono::steady_clock::now();
+    std::size_t operations = func();
+    auto stop = std::chrono::steady_clock::now();
+    double per_op =
+        std::chrono::duration<double, std::nano>(stop - start).count() / (operations ? operations : 1);
+    if (run == 0 || per_op < best) best = per_op;
+  }
+  std::cout << std::left << std::setw(48) << name << std::right << std::setw(12) << std::fixed
+            << std::setprecision(2) << best << " ns/op\n";
+  return best;
+}
+
+}  // namespace bench
+
+#endif  // JSON_BACKBONE_BENCH_HEADER
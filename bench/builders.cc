@@ -0,0 +1,62 @@
+#include <json_backbone.hpp>
+#include <map>
+#include <string>
+#include <vector>
+#include "bench.hpp"
+
+using namespace json_backbone;
+
+using json_container =
+    container<std::map, std::vector, std::string, std::nullptr_t, bool, int, double, std::string>;
+
+namespace {
+element_init<json_container> operator""_a(char const* name, size_t length) {
+  return json_container::key_type{name, length};
+}
+
+constexpr std::size_t depth = 16u;
+
+// Nested documents built with initializer lists, whose elements are copied at each level
+json_container with_initializer_lists(std::size_t level) {
+  if (!level) return make_object({"leaf"_a = true});
+  return make_object({"name"_a = "a name long enough to be allocated",  //
+                      "values"_a = make_array({json_container{1}, json_container{2}}),
+                      "child"_a = with_initializer_lists(level - 1u)});
+}
+
+// Same documents built with the variadic functions, which move their arguments
+json_container with_variadic_functions(std::size_t level) {
+  if (!level) return make_object("leaf"_a = true);
+  return make_object("name"_a = "a name long enough to be allocated",  //
+                     "values"_a = make_array(json_container{1}, json_container{2}),
+                     "child"_a = with_variadic_functions(level - 1u));
+}
+
+// Same documents built with builders
+json_container with_builders(std::size_t level) {
+  if (!level) return object_builder<json_container>{}.add("leaf", true).build();
+  return object_builder<json_container>{}
+      .add("name", "a name long enough to be allocated")
+      .add("values", array_builder<json_container>{2u}.add(1).add(2).build())
+      .add("child", with_builders(level - 1u))
+      .build();
+}
+
+template <class Build>
+std::size_t run(Build build) {
+  std::size_t const documents = 1024u;
+  for (std::size_t document = 0; document < documents; ++document) {
+    json_container built = build(depth);
+    bench::do_not_optimize(built);
+  }
+  return documents * depth;
+}
+}
+
+int main(void) {
+  std::cout << "nested documents of depth " << depth << "\n";
+  bench::measure("  initializer lists (per level)", [] { return run(with_initializer_lists); });
+  bench::measure("  variadic functions (per level)", [] { return run(with_variadic_functions); });
+  bench::measure("  builders (per level)", [] { return run(with_builders); });
+  return 0;
+}
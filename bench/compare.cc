@@ -0,0 +1,55 @@
+#include <json_backbone.hpp>
+#include <map>
+#include <string>
+#include <vector>
+#include "bench.hpp"
+
+using namespace json_backbone;
+
+using json_container =
+    container<std::map, std::vector, std::string, std::nullptr_t, bool, int, double, std::string>;
+using variant_type = json_container::variant_type;
+
+namespace {
+constexpr std::size_t records = 1u << 12u;
+
+json_container make_document() {
+  json_container document = json_container::array_type{};
+  for (std::size_t index = 0; index < records; ++index) {
+    json_container record = json_container::object_type{};
+    record["id"] = static_cast<int>(index);
+    record["name"] = "record " + std::to_string(index);
+    record["tags"] = json_container::array_type{std::string{"a"}, std::string{"b"}};
+    document.get<json_container::array_type>().push_back(std::move(record));
+  }
+  return document;
+}
+}
+
+int main(void) {
+  json_container const lhs = make_document();
+  json_container const rhs{lhs};
+
+  std::cout << "equality of equal documents\n";
+  bench::measure("  recursive variant operator== (per record)", [&lhs, &rhs] {
+    bench::do_not_optimize(static_cast<variant_type const&>(lhs) ==
+                           static_cast<variant_type const&>(rhs));
+    return records;
+  });
+  bench::measure("  iterative container operator== (per record)", [&lhs, &rhs] {
+    bench::do_not_optimize(lhs == rhs);
+    return records;
+  });
+
+  std::cout << "ordering of equal documents\n";
+  bench::measure("  recursive variant operator< (per record)", [&lhs, &rhs] {
+    bench::do_not_optimize(static_cast<variant_type const&>(lhs) <
+                           static_cast<variant_type const&>(rhs));
+    return records;
+  });
+  bench::measure("  iterative compare (per record)", [&lhs, &rhs] {
+    bench::do_not_optimize(compare(lhs, rhs));
+    return records;
+  });
+  return 0;
+}
@@ -0,0 +1,160 @@
+#include <json_backbone.hpp>
+#include <map>
+#include <string>
+#include <vector>
+#include "bench.hpp"
+
+using namespace json_backbone;
+
+using json_container =
+    container<std::map, std::vector, std::string, std::nullptr_t, bool, int, double, std::string>;
+
+namespace {
+constexpr std::size_t size = 1u << 16u;
+
+struct kind_visitor {
+  std::size_t operator()(std::nullptr_t) const { return 1u; }
+  std::size_t operator()(bool value) const { return value ? 2u : 3u; }
+  std::size_t operator()(int value) const { return static_cast<std::size_t>(value) & 7u; }
+  std::size_t operator()(double) const { return 4u; }
+  std::size_t operator()(std::string const& value) const { return value.size(); }
+  template <class T>
+  std::size_t operator()(T const& value) const {
+    return value.size();
+  }
+};
+
+// Tells if two values have the same kind
+struct same_kind_visitor {
+  template <class T>
+  bool operator()(T const&, T const&) const {
+    return true;
+  }
+  template <class T, class U>
+  bool operator()(T const&, U const&) const {
+    return false;
+  }
+};
+
+// Tells if three values have the same kind
+struct same_kinds_visitor {
+  template <class T>
+  bool operator()(T const&, T const&, T const&) const {
+    return true;
+  }
+  template <class T, class U, class V>
+  bool operator()(T const&, U const&, V const&) const {
+    return false;
+  }
+};
+
+// Same visitor, visiting one value after the other
+struct nested_kind_visitor {
+  template <class T>
+  struct inner {
+    T const& lhs;
+    template <class U>
+    bool operator()(U const& rhs) const {
+      return same_kind_visitor{}(lhs, rhs);
+    }
+  };
+
+  json_container const& rhs;
+  template <class T>
+  bool operator()(T const& lhs) const {
+    inner<T> visitor{lhs};
+    return apply_visitor<bool>(rhs, visitor);
+  }
+};
+
+// Evenly mixed scalar values, as in object fields
+void fill(std::vector<json_container>& values) {
+  values.reserve(size);
+  for (std::size_t index = 0; index < size; ++index) {
+    switch (index % 5u) {
+      case 0:
+        values.emplace_back(nullptr);
+        break;
+      case 1:
+        values.emplace_back(index % 3u == 0);
+        break;
+      case 2:
+        values.emplace_back(static_cast<int>(index));
+        break;
+      case 3:
+        values.emplace_back(static_cast<double>(index) * 0.5);
+        break;
+      default:
+        values.emplace_back(std::string{"short"});
+        break;
+    }
+  }
+}
+}
+
+int main(void) {
+  std::vector<json_container> values;
+  fill(values);
+  std::cout << "json_container dispatch\n";
+
+  bench::measure("  copy construct", [&values] {
+    std::vector<json_container> copy{values};
+    bench::do_not_optimize(copy);
+    return size;
+  });
+
+  std::vector<json_container> targets(values.rbegin(), values.rend());
+  bench::measure("  copy assign", [&values, &targets] {
+    for (std::size_t index = 0; index < size; ++index) targets[index] = values[index];
+    bench::do_not_optimize(targets);
+    return size;
+  });
+
+  bench::measure("  apply_visitor", [&values] {
+    std::size_t sum = 0u;
+    kind_visitor visitor;
+    for (auto& value : values) sum += apply_visitor<std::size_t>(value, visitor);
+    bench::do_not_optimize(sum);
+    return size;
+  });
+
+  bench::measure("  nested apply_visitor on pairs", [&values, &targets] {
+    std::size_t count = 0u;
+    for (std::size_t index = 0; index < size; ++index) {
+      nested_kind_visitor visitor{targets[index]};
+      count += apply_visitor<bool>(values[index], visitor) ? 1u : 0u;
+    }
+    bench::do_not_optimize(count);
+    return size;
+  });
+
+  bench::measure("  apply_visitor on pairs", [&values, &targets] {
+    std::size_t count = 0u;
+    for (std::size_t index = 0; index < size; ++index)
+      count += apply_visitor<bool>(same_kind_visitor{}, values[index], targets[index]) ? 1u : 0u;
+    bench::do_not_optimize(count);
+    return size;
+  });
+
+  std::vector<json_container> thirds(values.begin() + 1, values.end());
+  thirds.push_back(values.front());
+  bench::measure("  apply_visitor on triples", [&values, &targets, &thirds] {
+    std::size_t count = 0u;
+    for (std::size_t index = 0; index < size; ++index)
+      count += apply_visitor<bool>(same_kinds_visitor{}, values[index], targets[index],
+                                   thirds[index])
+                   ? 1u
+                   : 0u;
+    bench::do_not_optimize(count);
+    return size;
+  });
+
+  bench::measure("  operator==", [&values, &targets] {
+    std::size_t count = 0u;
+    for (std::size_t index = 0; index < size; ++index)
+      count += values[index] == targets[index] ? 1u : 0u;
+    bench::do_not_optimize(count);
+    return size;
+  });
+  return 0;
+}
@@ -0,0 +1,87 @@
+#include <json_backbone.hpp>
+#include <json_backbone/hash.hpp>
+#include <map>
+#include <string>
+#include <vector>
+#include "bench.hpp"
+
+using namespace json_backbone;
+
+// Heap values are shared between copies so that interned subtrees are shared in memory
+using shared_container =
+    container<std::map, std::vector, std::string, std::nullptr_t, std::string, bool, int, double>;
+
+namespace json_backbone {
+template <class... Others>
+struct variant_traits<std::nullptr_t, std::string, bool, int, double, Others...>
+    : default_variant_traits<std::nullptr_t, std::string, bool, int, double, Others...> {
+  static constexpr bool copy_on_write = true;
+};
+}
+
+namespace {
+using array_type = shared_container::array_type;
+using object_type = shared_container::object_type;
+
+constexpr std::size_t records = 1u << 14u;
+
+// Log like records, most of their content repeats
+shared_container make_document() {
+  char const* const levels[] = {"debug", "info", "warning", "error"};
+  shared_container document = array_type{};
+  for (std::size_t index = 0; index < records; ++index) {
+    shared_container source = object_type{};
+    source["service"] = std::string{"authentication service"};
+    source["host"] = std::string{"host-"} + std::to_string(index % 8u);
+    shared_container record = object_type{};
+    record["level"] = std::string{levels[index % 4u]};
+    record["source"] = std::move(source);
+    record["tags"] = array_type{std::string{"production"}, std::string{"europe-west"}};
+    record["code"] = static_cast<int>(index % 16u);
+    document.get<array_type>().push_back(std::move(record));
+  }
+  return document;
+}
+}
+
+int main(void) {
+  shared_container const document = make_document();
+  std::cout << "highly repetitive document of " << records << " records\n";
+
+  bench::measure("  structural hash (per record)", [&document] {
+    bench::do_not_optimize(std::hash<shared_container>{}(document));
+    return records;
+  });
+
+  bench::measure("  copy (per record)", [&document] {
+    shared_container copy{document.get<array_type>()};
+    bench::do_not_optimize(copy);
+    return records;
+  });
+
+  bench::measure("  hash consing (per record)", [&document] {
+    hash_cons<shared_container> table;
+    shared_container interned = table.intern(document);
+    bench::do_not_optimize(interned);
+    return records;
+  });
+
+  hash_cons<shared_container> table;
+  shared_container const interned = table.intern(document);
+  std::cout << "  " << table.size() << " unique nodes\n";
+
+  bench::measure("  structural hash of the interned document (per record)", [&interned] {
+    bench::do_not_optimize(std::hash<shared_container>{}(interned));
+    return records;
+  });
+
+  bench::measure("  equality of interned records (per record)", [&interned] {
+    array_type const& array = interned.get<array_type>();
+    std::size_t equal = 0u;
+    for (std::size_t index = 1; index < array.size(); ++index)
+      equal += array[index] == array[index - 1u] ? 1u : 0u;
+    bench::do_not_optimize(equal);
+    return records;
+  });
+  return 0;
+}
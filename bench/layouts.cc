@@ -0,0 +1,108 @@
+#include <json_backbone.hpp>
+#include <map>
+#include <string>
+#include <vector>
+#include "bench.hpp"
+
+using namespace json_backbone;
+
+// Types are ordered differently to select layouts through variant_traits
+using inline_container =
+    container<std::map, std::vector, std::string, std::nullptr_t, bool, int, double, std::string>;
+using boxed_container =
+    container<std::map, std::vector, std::string, std::nullptr_t, bool, double, int, std::string>;
+using tagged_container =
+    container<std::map, std::vector, std::string, std::nullptr_t, int, bool, double, std::string>;
+
+namespace json_backbone {
+template <class... Others>
+struct variant_traits<std::nullptr_t, bool, double, int, std::string, Others...>
+    : default_variant_traits<std::nullptr_t, bool, double, int, std::string, Others...> {
+  using layout = nan_boxed_layout;
+};
+
+template <class... Others>
+struct variant_traits<std::nullptr_t, int, bool, double, std::string, Others...>
+    : default_variant_traits<std::nullptr_t, int, bool, double, std::string, Others...> {
+  using layout = pointer_tagged_layout;
+};
+}
+
+namespace {
+constexpr std::size_t size = 1u << 16u;
+
+struct sum_visitor {
+  double operator()(double value) const { return value; }
+  double operator()(int value) const { return value; }
+  double operator()(bool value) const { return value ? 1. : 0.; }
+  template <class T>
+  double operator()(T const&) const {
+    return 0.;
+  }
+};
+
+// Mostly doubles, as in numeric documents
+template <class Container>
+void fill(std::vector<Container>& values) {
+  values.reserve(size);
+  for (std::size_t index = 0; index < size; ++index) {
+    switch (index % 16u) {
+      case 0:
+        values.emplace_back(nullptr);
+        break;
+      case 1:
+        values.emplace_back(index % 3u == 0);
+        break;
+      case 2:
+      case 3:
+        values.emplace_back(static_cast<int>(index));
+        break;
+      default:
+        values.emplace_back(static_cast<double>(index) * 0.5);
+        break;
+    }
+  }
+}
+
+template <class Container>
+void run(std::string const& name) {
+  std::cout << name << " (sizeof " << sizeof(Container) << ")\n";
+  std::vector<Container> values;
+  fill(values);
+
+  bench::measure("  construct", [] {
+    std::vector<Container> built;
+    fill(built);
+    bench::do_not_optimize(built);
+    return size;
+  });
+
+  bench::measure("  copy", [&values] {
+    std::vector<Container> copy{values};
+    bench::do_not_optimize(copy);
+    return size;
+  });
+
+  bench::measure("  is<double>()", [&values] {
+    std::size_t count = 0;
+    for (auto& value : values) count += value.template is<double>() ? 1u : 0u;
+    bench::do_not_optimize(count);
+    return size;
+  });
+
+  bench::measure("  apply_visitor", [&values] {
+    double sum = 0.;
+    sum_visitor visitor;
+    for (auto& value : values) sum += apply_visitor<double>(value, visitor);
+    bench::do_not_optimize(sum);
+    return size;
+  });
+}
+}
+
+int main(void) {
+  run<inline_container>("inline_layout");
+  run<boxed_container>("nan_boxed_layout");
+  run<tagged_container>("pointer_tagged_layout");
+  return 0;
+}
@@ -0,0 +1,78 @@
+#include <json_backbone.hpp>
+#include <json_backbone/flat_object.hpp>
+#include <json_backbone/hybrid_object.hpp>
+#include <json_backbone/symbol.hpp>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "bench.hpp"
+
+using namespace json_backbone;
+
+template <template <class...> class ObjectBase, class Key = std::string>
+using bench_container =
+    container<ObjectBase, std::vector, Key, std::nullptr_t, bool, int, double, std::string>;
+
+namespace {
+std::vector<std::string> make_keys(std::size_t size) {
+  std::vector<std::string> keys;
+  for (std::size_t index = 0; index < size; ++index)
+    keys.push_back("field_" + std::to_string(index * 7919u % 10007u));
+  return keys;
+}
+
+template <class Container>
+void run(std::string const& name, std::size_t size) {
+  using object_type = typename Container::object_type;
+  std::vector<std::string> const strings = make_keys(size);
+  std::vector<typename Container::key_type> const keys(strings.begin(), strings.end());
+  std::size_t const repeat = (1u << 16u) / size;
+
+  object_type object;
+  for (std::size_t index = 0; index < size; ++index) object[keys[index]] = static_cast<int>(index);
+
+  std::cout << name << " (" << size << " keys)\n";
+  bench::measure("  construction (per key)", [&keys, size, repeat] {
+    for (std::size_t round = 0; round < repeat; ++round) {
+      object_type built;
+      for (std::size_t index = 0; index < size; ++index)
+        built[keys[index]] = static_cast<int>(index);
+      bench::do_not_optimize(built);
+    }
+    return repeat * size;
+  });
+
+  bench::measure("  lookup", [&keys, &object, size, repeat] {
+    std::size_t found = 0u;
+    for (std::size_t round = 0; round < repeat; ++round)
+      for (std::size_t index = 0; index < size; ++index)
+        found += object.find(keys[index]) != object.end() ? 1u : 0u;
+    bench::do_not_optimize(found);
+    return repeat * size;
+  });
+
+  bench::measure("  iteration (per key)", [&object, size, repeat] {
+    std::size_t sum = 0u;
+    for (std::size_t round = 0; round < repeat; ++round)
+      for (auto const& element : object) sum += element.first.size() + element.second.type_index();
+    bench::do_not_optimize(sum);
+    return repeat * size;
+  });
+}
+
+template <class Container>
+void run_sizes(std::string const& name) {
+  for (std::size_t size : {4u, 32u, 1024u}) run<Container>(name, size);
+}
+}
+
+int main(void) {
+  run_sizes<bench_container<flat_object>>("flat_object");
+  run_sizes<bench_container<hybrid_object>>("hybrid_object");
+  run_sizes<bench_container<std::map>>("std::map");
+  run_sizes<bench_container<std::unordered_map>>("std::unordered_map");
+  run_sizes<bench_container<std::map, symbol>>("std::map with symbol keys");
+  run_sizes<bench_container<hybrid_object, symbol>>("hybrid_object with symbol keys");
+  return 0;
+}
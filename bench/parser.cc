@@ -0,0 +1,98 @@
+#include <json_backbone.hpp>
+#include <json_backbone/parser.hpp>
+#include <map>
+#include <string>
+#include <vector>
+#include "bench.hpp"
+#if defined(JSON_BACKBONE_BENCH_RAPIDJSON)
+#include <rapidjson/document.h>
+#endif
+
+using namespace json_backbone;
+
+using json_container =
+    container<std::map, std::vector, std::string, std::nullptr_t, bool, int, double, std::string>;
+
+namespace {
+constexpr std::size_t records = 1u << 15u;
+
+// Builds a text of a few megabytes mixing every kind of value
+std::string make_text(bool pretty) {
+  std::string const indent = pretty ? "\n    " : "";
+  std::string text = "[";
+  for (std::size_t index = 0; index < records; ++index) {
+    if (index) text += ",";
+    text += indent + "{\"id\": " + std::to_string(index) + "," + indent + "\"name\": \"record " +
+            std::to_string(index) + " with a description long enough to leave small buffers\"," +
+            indent + "\"score\": " + std::to_string(index * 0.37) + "," + indent +
+            "\"active\": " + (index % 2 ? "true" : "false") + "," + indent +
+            "\"tags\": [\"alpha\", \"beta\\n\", null]}";
+  }
+  return text + "]";
+}
+
+#if defined(JSON_BACKBONE_BENCH_RAPIDJSON)
+// Converts a rapidjson document the way it was done before the native parser
+json_container convert(rapidjson::Value const& value) {
+  switch (value.GetType()) {
+    case rapidjson::kNullType:
+      return json_container{nullptr};
+    case rapidjson::kFalseType:
+    case rapidjson::kTrueType:
+      return json_container{value.GetBool()};
+    case rapidjson::kStringType:
+      return json_container{std::string{value.GetString(), value.GetStringLength()}};
+    case rapidjson::kNumberType:
+      return value.IsInt() ? json_container{value.GetInt()} : json_container{value.GetDouble()};
+    case rapidjson::kArrayType: {
+      json_container::array_type array;
+      array.reserve(value.Size());
+      for (auto const& element : value.GetArray()) array.push_back(convert(element));
+      return json_container{std::move(array)};
+    }
+    case rapidjson::kObjectType: {
+      json_container::object_type object;
+      for (auto const& member : value.GetObject())
+        object.emplace(std::string{member.name.GetString(), member.name.GetStringLength()},
+                       convert(member.value));
+      return json_container{std::move(object)};
+    }
+  }
+  return json_container{};
+}
+#endif
+
+void measure_text(std::string const& name, std::string const& text) {
+  double const megabytes = static_cast<double>(text.size()) / (1024. * 1024.);
+  std::cout << name << ", " << std::fixed << std::setprecision(2) << megabytes << " MB\n";
+
+  // Parsed documents are kept so that their destruction is not measured
+  std::vector<json_container> documents;
+  parser<json_container> reused;
+  double const native = bench::measure("  native parser (per record)", [&] {
+    documents.push_back(reused.parse(text));
+    return records;
+  });
+  std::cout << "  native parser throughput " << std::setw(30)
+            << megabytes * 1e9 / (native * records) << " MB/s\n";
+
+#if defined(JSON_BACKBONE_BENCH_RAPIDJSON)
+  double const converted = bench::measure("  rapidjson then convert (per record)", [&] {
+    rapidjson::Document document;
+    document.Parse(text.c_str());
+    documents.push_back(convert(document));
+    return records;
+  });
+  std::cout << "  rapidjson then convert throughput " << std::setw(21)
+            << megabytes * 1e9 / (converted * records) << " MB/s\n";
+#else
+  std::cout << "  rapidjson not found, skipping the rapidjson then convert path\n";
+#endif
+}
+}
+
+int main(void) {
+  measure_text("minified text", make_text(false));
+  measure_text("pretty printed text", make_text(true));
+  return 0;
+}
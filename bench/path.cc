@@ -0,0 +1,65 @@
+#include <json_backbone.hpp>
+#include <json_backbone/path.hpp>
+#include <map>
+#include <string>
+#include <vector>
+#include "bench.hpp"
+
+using namespace json_backbone;
+
+using json_container =
+    container<std::map, std::vector, std::string, std::nullptr_t, bool, int, double, std::string>;
+
+namespace {
+constexpr std::size_t lookups = 1u << 18u;
+
+// Builds {"a": {"b": [{"c": 0}, ..., {"c": 7}], ...}, ...} with a few siblings at each level
+json_container make_document() {
+  json_container root = json_container::object_type{};
+  for (int sibling = 0; sibling < 8; ++sibling) {
+    json_container::array_type array;
+    for (int index = 0; index < 8; ++index) {
+      json_container element = json_container::object_type{};
+      element["c"] = index;
+      element["d"] = "other";
+      array.push_back(std::move(element));
+    }
+    json_container inner = json_container::object_type{};
+    inner["b"] = std::move(array);
+    inner["x" + std::to_string(sibling)] = sibling;
+    root[sibling ? "a" + std::to_string(sibling) : "a"] = std::move(inner);
+  }
+  return root;
+}
+}
+
+int main(void) {
+  json_container const document = make_document();
+  auto const root = make_view(document);
+
+  std::cout << "nested lookup of /a/b/3/c\n";
+  bench::measure("  chained view operator[]", [&root] {
+    int sum = 0;
+    for (std::size_t round = 0; round < lookups; ++round)
+      sum += root["a"]["b"][3]["c"].get<int>(0);
+    bench::do_not_optimize(sum);
+    return lookups;
+  });
+
+  bench::measure("  chained view operator[] with string keys", [&root] {
+    std::string const a{"a"}, b{"b"}, c{"c"};
+    int sum = 0;
+    for (std::size_t round = 0; round < lookups; ++round) sum += root[a][b][3][c].get<int>(0);
+    bench::do_not_optimize(sum);
+    return lookups;
+  });
+
+  path<json_container> const compiled{"/a/b/3/c"};
+  bench::measure("  compiled path", [&compiled, &document] {
+    int sum = 0;
+    for (std::size_t round = 0; round < lookups; ++round) sum += compiled(document).get<int>(0);
+    bench::do_not_optimize(sum);
+    return lookups;
+  });
+  return 0;
+}
@@ -0,0 +1,55 @@
+#include <json_backbone.hpp>
+#include <json_backbone/pool.hpp>
+#include <map>
+#include <string>
+#include <vector>
+#include "bench.hpp"
+
+using namespace json_backbone;
+
+// Types are ordered differently to select the allocator through variant_traits
+using default_container =
+    container<std::map, std::vector, std::string, std::nullptr_t, bool, int, double, std::string>;
+using pooled_container =
+    container<std::map, std::vector, std::string, std::nullptr_t, int, bool, double, std::string>;
+
+namespace json_backbone {
+template <class... Others>
+struct variant_traits<std::nullptr_t, int, bool, double, std::string, Others...>
+    : default_variant_traits<std::nullptr_t, int, bool, double, std::string, Others...> {
+  using allocator_type = pool_allocator<char>;
+};
+}
+
+namespace {
+constexpr std::size_t documents = 256u;
+constexpr std::size_t fields = 64u;
+
+// Builds and destroys small documents, as a request handler would
+template <class Container>
+std::size_t build_and_destroy() {
+  std::size_t count = 0u;
+  for (std::size_t document = 0; document < documents; ++document) {
+    Container root = typename Container::object_type{};
+    for (std::size_t field = 0; field < fields; ++field) {
+      typename Container::array_type values;
+      values.emplace_back(std::string{"some string value"});
+      values.emplace_back(static_cast<double>(field));
+      root[std::to_string(field)] = std::move(values);
+    }
+    count += root.template get<typename Container::object_type>().size();
+    bench::do_not_optimize(root);
+  }
+  return count;
+}
+}
+
+int main(void) {
+  std::cout << "build and destroy documents\n";
+  bench::measure("  std::allocator (per field)", [] { return build_and_destroy<default_container>(); });
+  bench::measure("  pool_allocator (per field)", [] { return build_and_destroy<pooled_container>(); });
+  pool_stats const& stats = size_class_pool::local().stats();
+  std::cout << "  pool: " << stats.allocations << " allocations, " << stats.reuses << " reuses, "
+            << stats.cached_bytes << " cached bytes\n";
+  return 0;
+}
@@ -0,0 +1,62 @@
+#include <json_backbone.hpp>
+#include <json_backbone/reclaimer.hpp>
+#include <map>
+#include <string>
+#include <vector>
+#include "bench.hpp"
+
+using namespace json_backbone;
+
+using json_container =
+    container<std::map, std::vector, std::string, std::nullptr_t, bool, int, double, std::string>;
+
+namespace {
+constexpr std::size_t documents = 16u;
+constexpr std::size_t records = 1u << 12u;
+
+json_container make_document() {
+  json_container document = json_container::array_type{};
+  for (std::size_t index = 0; index < records; ++index) {
+    json_container record = json_container::object_type{};
+    record["id"] = static_cast<int>(index);
+    record["name"] = "a record name long enough for the heap " + std::to_string(index);
+    record["tags"] = json_container::array_type{std::string{"a"}, std::string{"b"}};
+    document.get<json_container::array_type>().push_back(std::move(record));
+  }
+  return document;
+}
+
+// Times how long the calling thread spends dropping prepared documents
+template <class Drop>
+void measure_drop(std::string const& name, Drop drop) {
+  std::vector<std::vector<json_container>> runs(5u);
+  for (auto& run : runs)
+    for (std::size_t index = 0; index < documents; ++index) run.push_back(make_document());
+  std::size_t next = 0u;
+  bench::measure(name, [&runs, &next, &drop] {
+    for (json_container& document : runs[next]) drop(document);
+    ++next;
+    return documents;
+  });
+}
+}
+
+int main(void) {
+  reclaimer<json_container> queue;
+
+  std::cout << "dropping documents of " << records << " records\n";
+  measure_drop("  destroy in place (per document)", [](json_container& document) {
+    json_container{std::move(document)};
+  });
+  measure_drop("  measure footprint only (per document)", [](json_container& document) {
+    bench::do_not_optimize(measure_footprint(document));
+  });
+  measure_drop("  retire to the reclaimer (per document)", [&queue](json_container& document) {
+    queue.retire(std::move(document));
+  });
+  queue.drain();
+  reclaimer_stats const stats = queue.stats();
+  std::cout << "reclaimed " << stats.reclaimed_documents << " documents, " << stats.reclaimed_nodes
+            << " nodes, " << stats.reclaimed_bytes << " bytes\n";
+  return 0;
+}
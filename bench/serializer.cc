@@ -0,0 +1,111 @@
+#include <json_backbone.hpp>
+#include <json_backbone/serializer.hpp>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "bench.hpp"
+
+using namespace json_backbone;
+
+using json_container =
+    container<std::map, std::vector, std::string, std::nullptr_t, bool, int, double, std::string>;
+
+namespace {
+constexpr std::size_t records = 1u << 14u;
+
+json_container make_document() {
+  json_container document = json_container::array_type{};
+  for (std::size_t index = 0; index < records; ++index) {
+    json_container record = json_container::object_type{};
+    record["id"] = static_cast<int>(index);
+    record["name"] = "record " + std::to_string(index) + " with a \"quoted\" description\n";
+    record["score"] = static_cast<double>(index) * 0.37;
+    record["ratio"] = 1. / static_cast<double>(index + 1u);
+    record["active"] = 0u == index % 2u;
+    record["tags"] = json_container::array_type{std::string{"alpha"}, std::string{"beta"}, nullptr};
+    document.get<json_container::array_type>().push_back(std::move(record));
+  }
+  return document;
+}
+
+// The visitor documented before the serializer, printing doubles with 17 digits to round trip
+struct stream_serializer {
+  std::ostringstream& output;
+
+  void operator()(json_container::object_type const& value) {
+    output << "{";
+    bool first = true;
+    for (auto& element : value) {
+      if (!first) output << ",";
+      first = false;
+      output << "\"" << element.first << "\":";
+      apply_visitor<void>(element.second, *this);
+    }
+    output << "}";
+  }
+
+  void operator()(json_container::array_type const& value) {
+    output << "[";
+    bool first = true;
+    for (auto& element : value) {
+      if (!first) output << ",";
+      first = false;
+      apply_visitor<void>(element, *this);
+    }
+    output << "]";
+  }
+
+  void operator()(std::string const& value) { output << '"' << value << '"'; }
+  void operator()(std::nullptr_t) { output << "null"; }
+  void operator()(bool value) { output << (value ? "true" : "false"); }
+  void operator()(int value) { output << value; }
+  void operator()(double value) { output << value; }
+};
+}
+
+int main(void) {
+  json_container const document = make_document();
+  double const megabytes = static_cast<double>(to_json(document).size()) / (1024. * 1024.);
+  std::cout << "serializing " << records << " records, " << std::fixed << std::setprecision(2)
+            << megabytes << " MB\n";
+
+  auto report = [megabytes](double per_record) {
+    std::cout << "  throughput " << std::setw(44) << megabytes * 1e9 / (per_record * records)
+              << " MB/s\n";
+  };
+
+  report(bench::measure("  ostringstream visitor (per record)", [&document] {
+    std::ostringstream stream;
+    stream.precision(17);
+    stream_serializer visitor{stream};
+    apply_visitor<void>(document, visitor);
+    bench::do_not_optimize(stream.str());
+    return records;
+  }));
+
+  std::string output;
+  report(bench::measure("  serializer to a string (per record)", [&document, &output] {
+    output.clear();
+    string_sink sink{output};
+    serialize(document, sink);
+    bench::do_not_optimize(output);
+    return records;
+  }));
+
+  report(bench::measure("  serializer pretty printing (per record)", [&document, &output] {
+    output.clear();
+    string_sink sink{output};
+    serialize(document, sink, 2u);
+    bench::do_not_optimize(output);
+    return records;
+  }));
+
+  report(bench::measure("  serializer to an ostringstream (per record)", [&document] {
+    std::ostringstream stream;
+    serialize(document, stream);
+    bench::do_not_optimize(stream.str());
+    return records;
+  }));
+  return 0;
+}
@@ -0,0 +1,53 @@
+#include <json_backbone.hpp>
+#include <json_backbone/compact_string.hpp>
+#include <map>
+#include <string>
+#include <vector>
+#include "bench.hpp"
+
+using namespace json_backbone;
+
+template <class String>
+using bench_container =
+    container<std::map, std::vector, std::string, std::nullptr_t, bool, int, double, String>;
+
+namespace {
+// Short enum like values, as most strings of our documents
+char const* const statuses[] = {"active", "pending", "closed", "on_hold", "new", "failed"};
+constexpr std::size_t values = 1u << 16u;
+
+template <class Container>
+void run(std::string const& name) {
+  using array_type = typename Container::array_type;
+  std::cout << name << "\n";
+
+  bench::measure("  construction", [] {
+    array_type array;
+    array.reserve(values);
+    for (std::size_t index = 0; index < values; ++index) array.emplace_back(statuses[index % 6u]);
+    bench::do_not_optimize(array);
+    return values;
+  });
+
+  array_type array;
+  for (std::size_t index = 0; index < values; ++index) array.emplace_back(statuses[index % 6u]);
+  bench::measure("  copy", [&array] {
+    array_type copy{array};
+    bench::do_not_optimize(copy);
+    return values;
+  });
+
+  bench::measure("  conversion to std::string", [&array] {
+    std::size_t size = 0u;
+    for (auto const& value : array) size += make_view(value).template as<std::string>().size();
+    bench::do_not_optimize(size);
+    return values;
+  });
+}
+}
+
+int main(void) {
+  run<bench_container<std::string>>("std::string");
+  run<bench_container<compact_string>>("compact_string");
+  return 0;
+}
@@ -0,0 +1,57 @@
+#include <json_backbone.hpp>
+#include <map>
+#include <string>
+#include <vector>
+#include "bench.hpp"
+
+using namespace json_backbone;
+
+using json_container =
+    container<std::map, std::vector, std::string, std::nullptr_t, bool, int, double, std::string>;
+
+namespace {
+constexpr std::size_t repeat = 5u;
+constexpr std::size_t nodes = 1u << 16u;
+
+json_container make_deep() {
+  json_container value{1};
+  for (std::size_t level = 0; level < nodes; ++level) {
+    json_container::array_type array;
+    array.push_back(std::move(value));
+    value = std::move(array);
+  }
+  return value;
+}
+
+json_container make_wide() {
+  json_container document = json_container::array_type{};
+  for (std::size_t index = 0; index < nodes / 4u; ++index) {
+    json_container record = json_container::object_type{};
+    record["id"] = static_cast<int>(index);
+    record["name"] = "record " + std::to_string(index);
+    record["tags"] = json_container::array_type{std::string{"a"}};
+    document.get<json_container::array_type>().push_back(std::move(record));
+  }
+  return document;
+}
+
+// Destroys one of the prepared documents per run
+template <class Make>
+void measure_teardown(std::string const& name, Make make) {
+  std::vector<json_container> documents;
+  for (std::size_t run = 0; run < repeat; ++run) documents.push_back(make());
+  bench::measure(name,
+                 [&documents] {
+                   documents.pop_back();
+                   return nodes;
+                 },
+                 repeat);
+}
+}
+
+int main(void) {
+  std::cout << "teardown\n";
+  measure_teardown("  deep nested arrays (per node)", make_deep);
+  measure_teardown("  wide array of records (per node)", make_wide);
+  return 0;
+}
@@ -2,11 +2,20 @@
 #define JSON_BACKBONE_BASE_HEADER
 #include <type_traits>
 #include <utility>
+#include <tuple>
 #include <functional>
 #include <exception>
+#include <stdexcept>
 #include <limits>
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
 #include <array>
+#include <atomic>
+#include <memory>
+#include <new>
 #include <initializer_list>
+#include <vector>
 
 namespace json_backbone {
 //
@@ -60,12 +69,21 @@ using bounded_identity_t = typename bounded_identity<T>::type;
 // Is small type
 template <class T>
 struct is_small_type : std::integral_constant<bool, (sizeof(T) <= sizeof(T*))> {};
-template <class T, bool IsRecursive = is_recursive<T>::value>
+
+//
+// is_small_type_impl tells if a type is small given the inline capacity of a variant
+//
+// Types no wider than a pointer are small if is_small_type says so. Wider types are small
+// if is_small_type says so or if they fit the inline capacity.
+//
+template <class T, std::size_t Capacity = sizeof(void*), bool IsRecursive = is_recursive<T>::value>
 struct is_small_type_impl;
-template <class T>
-struct is_small_type_impl<T, false> : std::integral_constant<bool, is_small_type<T>::value> {};
-template <class T>
-struct is_small_type_impl<T, true> : std::false_type {};
+template <class T, std::size_t Capacity>
+struct is_small_type_impl<T, Capacity, false>
+    : std::integral_constant<bool, (is_small_type<T>::value ||
+                                    (sizeof(void*) < sizeof(T) && sizeof(T) <= Capacity))> {};
+template <class T, std::size_t Capacity>
+struct is_small_type_impl<T, Capacity, true> : std::false_type {};
 
 //
 // memory_footprint_t represents minimum size needed to store the type
@@ -74,19 +92,35 @@ struct is_small_type_impl<T, true> : std::false_type {};
 // this type wether it is a small type or not. Big types needs to
 // be pointed to while small ones are directly stored
 //
-template <class T, bool IsRecursive = is_recursive<T>::value>
+template <class T, std::size_t Capacity = sizeof(void*), bool IsRecursive = is_recursive<T>::value>
 struct memory_footprint;
-template <class T>
-struct memory_footprint<T, false>
-    : std::integral_constant<std::size_t,
-                             (is_small_type_impl<T>::value ? sizeof(T) : sizeof(void*))> {};
-template <class T>
-struct memory_footprint<T, true> : std::integral_constant<std::size_t, sizeof(void*)> {};
+template <class T, std::size_t Capacity>
+struct memory_footprint<T, Capacity, false>
+    : std::integral_constant<std::size_t, (is_small_type_impl<T, Capacity>::value ? sizeof(T)
+                                                                                  : sizeof(void*))> {
+};
+template <class T, std::size_t Capacity>
+struct memory_footprint<T, Capacity, true> : std::integral_constant<std::size_t, sizeof(void*)> {};
 
 // Helper to generate adequate allocations and deallocation functions
-template <class T, std::size_t MemSize>
-struct store_on_stack : std::integral_constant<bool, (is_small_type_impl<T>::value &&
-                                                      memory_footprint<T>::value <= MemSize)> {};
+template <class T, std::size_t MemSize, std::size_t Capacity = sizeof(void*)>
+struct store_on_stack
+    : std::integral_constant<bool, (is_small_type_impl<T, Capacity>::value &&
+                                    memory_footprint<T, Capacity>::value <= MemSize)> {};
+
+//
+// memory_alignment represents the alignment needed to store the type
+//
+// Types stored on the stack need their own alignment, other ones only
+// need the alignment of the pointer to their heap location. Alignment
+// of recursive types is never computed since they may be incomplete.
+//
+template <class T, std::size_t MemSize, std::size_t Capacity = sizeof(void*),
+          bool OnStack = store_on_stack<T, MemSize, Capacity>::value>
+struct memory_alignment : std::integral_constant<std::size_t, alignof(void*)> {};
+template <class T, std::size_t MemSize, std::size_t Capacity>
+struct memory_alignment<T, MemSize, Capacity, true>
+    : std::integral_constant<std::size_t, alignof(bounded_identity_t<T>)> {};
 
 //
 // arithmetics provides compile time arithmetics over arrays
@@ -126,6 +160,11 @@ bool constexpr all_equals(std::array<I, N> const& values, I current_value,
                                          ? all_equals(values, current_value, current_index + 1)
                                          : false;
 }
+
+template <class I, std::size_t N>
+I constexpr product(std::array<I, N> const& values, std::size_t current_index = 0) {
+  return N <= current_index ? I{1} : values.at(current_index) * product(values, current_index + 1);
+}
 };
 
 //
@@ -155,6 +194,9 @@ struct type_info {};
 //
 template <std::size_t... Is, class... Types>
 struct type_list<std::index_sequence<Is...>, Types...> : type_info<Types, Is>... {
+  // Number of types in the list
+  static constexpr std::size_t size = sizeof...(Types);
+
   //
   // Returns the index as integral constant of the given type in the list
   //
@@ -337,21 +379,726 @@ struct bounded_type_traits {
 };
 }  // namespace type_list_traits
 
+//
+// select_index_type returns the smallest unsigned type able to hold every index
+// of a list of Size types, plus the "no type" index equal to Size
+//
+template <std::size_t Size>
+struct select_index_type {
+  using type = std::conditional_t<
+      (Size <= std::numeric_limits<std::uint8_t>::max()), std::uint8_t,
+      std::conditional_t<(Size <= std::numeric_limits<std::uint16_t>::max()), std::uint16_t,
+                         std::size_t>>;
+};
+
+//
+// Layouts define how a variant stores its values and its discriminator
+//
+// A layout provides a storage template instantiated with the variant traits and the bounded
+// types. The storage must provide:
+// - is_inline<T> telling if a bounded type is stored in the storage itself
+// - memory_size and alignment constants
+// - index() and set_index(index) to read and write the discriminator of inline values
+// - holds(index) to test the discriminator
+// - address<T>() returning the location of an inline value
+// - pointer() and set_pointer(pointer, index) to read and write the location of a heap value
+//
+// Inline values are constructed before their index is set.
+//
+
+//
+// inline_layout stores small types in a buffer followed by the discriminator
+//
+// The discriminator lives in the trailing padding of the buffer.
+//
+struct inline_layout {
+  template <class Traits, class... Value>
+  class storage {
+    using Index = typename Traits::index_type;
+    static constexpr std::size_t capacity = Traits::inline_capacity;
+    static_assert(sizeof(void*) <= capacity, "Inline capacity must be able to hold a pointer.");
+
+    // Compute minimum size required by types. Default 8
+    static constexpr std::size_t min_memory_size =
+        arithmetics::max_value<std::size_t, sizeof...(Value)>(
+            {memory_footprint<Value, capacity>::value...});
+
+   public:
+    template <class T>
+    using is_inline = store_on_stack<T, min_memory_size, capacity>;
+
+    // Compute alignment required by the types held
+    static constexpr std::size_t alignment = arithmetics::max_value<std::size_t, sizeof...(Value)>(
+        {memory_alignment<Value, min_memory_size, capacity>::value...});
+
+    // Compute memory size of a buffer aligned on alignment wide enough to hold min_memory_size
+    static constexpr std::size_t memory_size =
+        alignment * (min_memory_size / alignment + (min_memory_size % alignment ? 1 : 0));
+
+   private:
+    alignas(alignment) unsigned char data_[memory_size] = {};
+    Index index_ = sizeof...(Value);
+
+   public:
+    inline std::size_t index() const noexcept { return index_; }
+
+    inline bool holds(std::size_t index) const noexcept { return index_ == index; }
+
+    inline void set_index(std::size_t index) noexcept { index_ = static_cast<Index>(index); }
+
+    template <class T>
+    inline void* address() noexcept {
+      return static_cast<void*>(data_);
+    }
+
+    template <class T>
+    inline void const* address() const noexcept {
+      return static_cast<void const*>(data_);
+    }
+
+    inline void* pointer() const noexcept {
+      void* value;
+      std::memcpy(&value, data_, sizeof(void*));
+      return value;
+    }
+
+    inline void set_pointer(void* value, std::size_t index) noexcept {
+      std::memcpy(data_, &value, sizeof(void*));
+      index_ = static_cast<Index>(index);
+    }
+  };
+};
+
+//
+// pointer_tagged_layout stores the discriminator in the low alignment bits of a single word
+//
+// Heap values are pointed to by the word, at most 8 bounded types are supported. Types
+// no wider than 32 bits are stored in the half of the word not holding the discriminator,
+// and std::nullptr_t is encoded as a null word. Any other type, even double, is stored on the
+// heap. Only available on 64 bits platforms.
+//
+struct pointer_tagged_layout {
+  // Types fitting the half of the word not holding the discriminator
+  template <class T, bool IsRecursive = is_recursive<T>::value>
+  struct fits_half_word : std::false_type {};
+  template <class T>
+  struct fits_half_word<T, false>
+      : std::integral_constant<bool, (sizeof(T) <= sizeof(std::uint32_t) &&
+                                      alignof(T) <= alignof(std::uint32_t))> {};
+
+  template <class Traits, class... Value>
+  class storage {
+    static_assert(sizeof(void*) == sizeof(std::uint64_t),
+                  "pointer_tagged_layout is only available on 64 bits platforms.");
+    static_assert(sizeof...(Value) <= 8, "pointer_tagged_layout supports at most 8 types.");
+    static_assert(alignof(std::max_align_t) >= 8, "Heap allocations must be aligned on 8 bytes.");
+
+    static constexpr std::uint64_t tag_mask = 7u;
+
+    // Tags are rotated so that std::nullptr_t, if any, is encoded by a null word
+    static constexpr std::size_t null_index =
+        arithmetics::find_first<bool, sizeof...(Value)>({std::is_null_pointer<Value>::value...},
+                                                        true) %
+        8u;
+
+    static constexpr std::uint64_t tag(std::size_t index) noexcept {
+      return (index + 8u - null_index) & tag_mask;
+    }
+
+    // Offset of the half word not holding the low bits
+    static inline std::size_t payload_offset() noexcept {
+      std::uint32_t const one = 1u;
+      unsigned char first;
+      std::memcpy(&first, &one, 1u);
+      return first ? sizeof(std::uint32_t) : 0u;
+    }
+
+    inline std::uint64_t word() const noexcept {
+      std::uint64_t value;
+      std::memcpy(&value, data_, sizeof(value));
+      return value;
+    }
+
+    alignas(std::uint64_t) unsigned char data_[sizeof(std::uint64_t)] = {};
+
+   public:
+    template <class T>
+    using is_inline = std::integral_constant<bool, (std::is_null_pointer<T>::value ||
+                                                    fits_half_word<T>::value)>;
+
+    static constexpr std::size_t alignment = alignof(std::uint64_t);
+    static constexpr std::size_t memory_size = sizeof(std::uint64_t);
+
+    inline std::size_t index() const noexcept {
+      return static_cast<std::size_t>((word() + null_index) & tag_mask);
+    }
+
+    inline bool holds(std::size_t index) const noexcept {
+      return (word() & tag_mask) == tag(index);
+    }
+
+    inline void set_index(std::size_t index) noexcept {
+      std::uint32_t const value = static_cast<std::uint32_t>(tag(index));
+      std::memcpy(data_ + (sizeof(std::uint32_t) - payload_offset()), &value, sizeof(value));
+    }
+
+    template <class T>
+    inline void* address() noexcept {
+      return static_cast<void*>(data_ + (std::is_null_pointer<T>::value ? 0u : payload_offset()));
+    }
+
+    template <class T>
+    inline void const* address() const noexcept {
+      return static_cast<void const*>(data_ +
+                                      (std::is_null_pointer<T>::value ? 0u : payload_offset()));
+    }
+
+    inline void* pointer() const noexcept {
+      return reinterpret_cast<void*>(static_cast<std::uintptr_t>(word() & ~tag_mask));
+    }
+
+    inline void set_pointer(void* value, std::size_t index) noexcept {
+      std::uint64_t const tagged = reinterpret_cast<std::uintptr_t>(value) | tag(index);
+      std::memcpy(data_, &tagged, sizeof(tagged));
+    }
+  };
+};
+
+//
+// nan_boxed_layout stores the whole variant in a single 64 bits word read as a double
+//
+// Exactly one bounded type must be double, at most 7 others are supported. Any word which is
+// not a negative quiet NaN with a payload tag in its 16 upper bits is a double value, so testing
+// for a double is a single comparison. Other types no wider than 32 bits are stored in the low
+// half of the word, heap pointers in its 48 low bits. std::nullptr_t carries no state and is
+// only encoded by its tag.
+//
+// NaN values are canonicalized when a double is stored through the variant, but not when written
+// through a reference: writing a negative NaN with a payload tag through raw<double>() breaks the
+// variant. NaN produced by arithmetics never do.
+//
+struct nan_boxed_layout {
+  template <class Traits, class... Value>
+  class storage {
+    static_assert(sizeof(void*) == sizeof(std::uint64_t),
+                  "nan_boxed_layout is only available on 64 bits platforms.");
+    static_assert(sizeof(double) == sizeof(std::uint64_t) && std::numeric_limits<double>::is_iec559,
+                  "nan_boxed_layout requires IEEE 754 doubles.");
+    static_assert(sizeof...(Value) <= 8, "nan_boxed_layout supports at most 8 types.");
+
+    static constexpr std::size_t double_index = arithmetics::find_first<bool, sizeof...(Value)>(
+        {std::is_same<Value, double>::value...}, true);
+    static_assert(double_index < sizeof...(Value), "nan_boxed_layout requires a double type.");
+
+    // Upper 16 bits of the first boxed tag. Lower values are doubles.
+    static constexpr std::uint64_t first_tag = 0xFFF9u;
+    static constexpr std::uint64_t payload_mask = 0x0000FFFFFFFFFFFFu;
+    static constexpr std::uint64_t canonical_nan = 0x7FF8000000000000u;
+
+    static constexpr std::uint64_t tag(std::size_t index) noexcept {
+      return first_tag + index - (double_index < index ? 1u : 0u);
+    }
+
+    // Offset of the low half of the word
+    static inline std::size_t payload_offset() noexcept {
+      std::uint32_t const one = 1u;
+      unsigned char first;
+      std::memcpy(&first, &one, 1u);
+      return first ? 0u : sizeof(std::uint32_t);
+    }
+
+    // Stateless location for std::nullptr_t, never read
+    static inline void* null_address() noexcept {
+      static thread_local std::nullptr_t value = nullptr;
+      return &value;
+    }
+
+    inline std::uint64_t word() const noexcept {
+      std::uint64_t value;
+      std::memcpy(&value, data_, sizeof(value));
+      return value;
+    }
+
+    alignas(std::uint64_t) unsigned char data_[sizeof(std::uint64_t)] = {};
+
+   public:
+    template <class T>
+    using is_inline = std::integral_constant<bool, (std::is_same<T, double>::value ||
+                                                    std::is_null_pointer<T>::value ||
+                                                    pointer_tagged_layout::fits_half_word<T>::value)>;
+
+    static constexpr std::size_t alignment = alignof(std::uint64_t);
+    static constexpr std::size_t memory_size = sizeof(std::uint64_t);
+
+    inline std::size_t index() const noexcept {
+      std::uint64_t const upper = word() >> 48u;
+      std::size_t const slot = static_cast<std::size_t>(upper - first_tag);
+      return upper < first_tag ? double_index : slot + (double_index <= slot ? 1u : 0u);
+    }
+
+    inline bool holds(std::size_t index) const noexcept {
+      return index == double_index ? (word() >> 48u) < first_tag : (word() >> 48u) == tag(index);
+    }
+
+    inline void set_index(std::size_t index) noexcept {
+      if (index == double_index) {
+        if (first_tag <= (word() >> 48u)) std::memcpy(data_, &canonical_nan, sizeof(canonical_nan));
+      } else {
+        std::uint32_t const upper = static_cast<std::uint32_t>(tag(index) << 16u);
+        std::memcpy(data_ + (sizeof(std::uint32_t) - payload_offset()), &upper, sizeof(upper));
+      }
+    }
+
+    template <class T>
+    inline void* address() noexcept {
+      return std::is_null_pointer<T>::value
+                 ? null_address()
+                 : static_cast<void*>(
+                       data_ + (std::is_same<T, double>::value ? 0u : payload_offset()));
+    }
+
+    template <class T>
+    inline void const* address() const noexcept {
+      return std::is_null_pointer<T>::value
+                 ? null_address()
+                 : static_cast<void const*>(
+                       data_ + (std::is_same<T, double>::value ? 0u : payload_offset()));
+    }
+
+    inline void* pointer() const noexcept {
+      return reinterpret_cast<void*>(static_cast<std::uintptr_t>(word() & payload_mask));
+    }
+
+    inline void set_pointer(void* value, std::size_t index) noexcept {
+      std::uint64_t const boxed = (tag(index) << 48u) | reinterpret_cast<std::uintptr_t>(value);
+      std::memcpy(data_, &boxed, sizeof(boxed));
+    }
+  };
+};
+
+//
+// default_variant_traits defines the storage policies of a variant
+//
+// Inherit from it when specializing variant_traits to override only some of them.
+//
+template <class... Value>
+struct default_variant_traits {
+  // Type used to store the discriminator. Can be overridden by any unsigned
+  // integral type wide enough to hold sizeof...(Value)
+  using index_type = typename select_index_type<sizeof...(Value)>::type;
+
+  // Layout of the values and the discriminator
+  using layout = inline_layout;
+
+  // Size up to which types are stored in the variant itself rather than on the heap. Respected
+  // by inline_layout only, the other layouts use a single word.
+  static constexpr std::size_t inline_capacity = sizeof(void*);
+
+  // Allocator used for heap values, rebound to each of them. Stateful allocators are default
+  // constructed when a value is created and stored in front of it.
+  using allocator_type = std::allocator<char>;
+
+  // Share heap values between copies, a value being cloned on its first mutable access. Moves
+  // hand heap values over, leaving their source with its default value when it is inline.
+  static constexpr bool copy_on_write = false;
+};
+
+//
+// variant_traits is the customization point for the storage policies of a variant
+//
+// A partial specialization on the leading bounded types also applies to containers,
+// since they only append their array and object types to the user's list:
+//
+// template <class... Others>
+// struct variant_traits<std::nullptr_t, bool, Others...>
+//     : default_variant_traits<std::nullptr_t, bool, Others...> {
+//   using index_type = std::size_t;
+// };
+//
+template <class... Value>
+struct variant_traits : default_variant_traits<Value...> {};
+
+//
+// memory_resource is an abstract interface to an unbounded set of memory blocks
+//
+// It mirrors std::pmr::memory_resource which is not available in C++14.
+//
+class memory_resource {
+  static constexpr std::size_t max_align = alignof(std::max_align_t);
+
+ public:
+  virtual ~memory_resource() = default;
+
+  void* allocate(std::size_t bytes, std::size_t alignment = max_align) {
+    return do_allocate(bytes, alignment);
+  }
+
+  void deallocate(void* pointer, std::size_t bytes, std::size_t alignment = max_align) {
+    do_deallocate(pointer, bytes, alignment);
+  }
+
+  bool is_equal(memory_resource const& other) const noexcept { return do_is_equal(other); }
+
+ private:
+  virtual void* do_allocate(std::size_t bytes, std::size_t alignment) = 0;
+  virtual void do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) = 0;
+  virtual bool do_is_equal(memory_resource const& other) const noexcept = 0;
+};
+
+inline bool operator==(memory_resource const& lhs, memory_resource const& rhs) noexcept {
+  return &lhs == &rhs || lhs.is_equal(rhs);
+}
+
+inline bool operator!=(memory_resource const& lhs, memory_resource const& rhs) noexcept {
+  return !(lhs == rhs);
+}
+
+namespace helpers {
+// new_delete_resource_impl forwards to the global operator new and delete
+class new_delete_resource_impl final : public memory_resource {
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    if (alignof(std::max_align_t) < alignment) throw std::bad_alloc{};
+    return ::operator new(bytes);
+  }
+
+  void do_deallocate(void* pointer, std::size_t, std::size_t) override {
+    ::operator delete(pointer);
+  }
+
+  bool do_is_equal(memory_resource const& other) const noexcept override {
+    return this == &other;
+  }
+};
+
+inline memory_resource*& default_resource() noexcept;
+}  // namespace helpers
+
+// Returns a resource using the global operator new and delete
+inline memory_resource* new_delete_resource() noexcept {
+  static helpers::new_delete_resource_impl resource;
+  return &resource;
+}
+
+namespace helpers {
+inline memory_resource*& default_resource() noexcept {
+  static thread_local memory_resource* resource = new_delete_resource();
+  return resource;
+}
+}  // namespace helpers
+
+//
+// Returns the default resource of the calling thread
+//
+// Unlike std::pmr, the default resource is thread local so that each thread
+// can build its documents on its own resource.
+//
+inline memory_resource* get_default_resource() noexcept { return helpers::default_resource(); }
+
+// Sets the default resource of the calling thread, returns the previous one
+inline memory_resource* set_default_resource(memory_resource* resource) noexcept {
+  memory_resource* previous = helpers::default_resource();
+  helpers::default_resource() = resource ? resource : new_delete_resource();
+  return previous;
+}
+
+// default_resource_guard sets the default resource of the calling thread for its lifetime
+class default_resource_guard {
+  memory_resource* previous_;
+
+ public:
+  explicit default_resource_guard(memory_resource& resource) noexcept
+      : previous_{set_default_resource(&resource)} {}
+  default_resource_guard(default_resource_guard const&) = delete;
+  default_resource_guard(default_resource_guard&& other) noexcept : previous_{other.previous_} {
+    other.previous_ = nullptr;
+  }
+  default_resource_guard& operator=(default_resource_guard const&) = delete;
+  ~default_resource_guard() {
+    if (previous_) set_default_resource(previous_);
+  }
+};
+
+//
+// polymorphic_allocator is an allocator using a memory_resource
+//
+// Default constructed allocators use the default resource of the calling thread.
+// Copies of containers are allocated on the default resource too.
+//
+template <class T>
+class polymorphic_allocator {
+  template <class U>
+  friend class polymorphic_allocator;
+
+  memory_resource* resource_;
+
+ public:
+  using value_type = T;
+
+  polymorphic_allocator() noexcept : resource_{get_default_resource()} {}
+  polymorphic_allocator(memory_resource* resource) noexcept : resource_{resource} {}
+  polymorphic_allocator(polymorphic_allocator const&) noexcept = default;
+  template <class U>
+  polymorphic_allocator(polymorphic_allocator<U> const& other) noexcept
+      : resource_{other.resource_} {}
+  polymorphic_allocator& operator=(polymorphic_allocator const&) = delete;
+
+  T* allocate(std::size_t size) {
+    return static_cast<T*>(resource_->allocate(size * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T* pointer, std::size_t size) {
+    resource_->deallocate(pointer, size * sizeof(T), alignof(T));
+  }
+
+  polymorphic_allocator select_on_container_copy_construction() const { return {}; }
+
+  memory_resource* resource() const noexcept { return resource_; }
+};
+
+template <class T, class U>
+inline bool operator==(polymorphic_allocator<T> const& lhs,
+                       polymorphic_allocator<U> const& rhs) noexcept {
+  return *lhs.resource() == *rhs.resource();
+}
+
+template <class T, class U>
+inline bool operator!=(polymorphic_allocator<T> const& lhs,
+                       polymorphic_allocator<U> const& rhs) noexcept {
+  return !(lhs == rhs);
+}
+
 //
 // helpers creates functions to be used by the variant
 //
 namespace helpers {
 
+//
+// heap_allocation creates and destroys heap values with an allocator
+//
+// Blocks are allocated in units aligned at least on a pointer so that
+// tagging layouts can use the low bits of their address. Stateful allocators
+// are stored in front of the value to deallocate it with the same allocator.
+//
+// Shared values are reference counted, the counter being stored right in
+// front of the value: share only increments it and unique clones the value
+// if it is shared. Otherwise share copies the value and unique does nothing.
+//
+template <class T, class Allocator, bool Shared = false>
+class heap_allocation {
+  static constexpr std::size_t unit_alignment =
+      alignof(void*) < alignof(T) ? alignof(T) : alignof(void*);
+  struct alignas(unit_alignment) unit {
+    unsigned char bytes[unit_alignment];
+  };
+  using allocator_type = typename std::allocator_traits<Allocator>::template rebind_alloc<unit>;
+  using allocator_traits = std::allocator_traits<allocator_type>;
+  using is_stateless = std::is_empty<allocator_type>;
+  using is_shared = std::integral_constant<bool, Shared>;
+  using counter_type = std::atomic<std::size_t>;
+  static_assert(alignof(allocator_type) <= unit_alignment, "Allocator alignment not supported.");
+  static_assert(alignof(counter_type) <= unit_alignment, "Counter alignment not supported.");
+
+  static constexpr std::size_t round_up(std::size_t size) {
+    return unit_alignment * ((size + unit_alignment - 1u) / unit_alignment);
+  }
+
+  static constexpr std::size_t allocator_size =
+      is_stateless::value ? 0u : round_up(sizeof(allocator_type));
+  static constexpr std::size_t counter_size = Shared ? round_up(sizeof(counter_type)) : 0u;
+  static constexpr std::size_t header_size = allocator_size + counter_size;
+  static constexpr std::size_t units =
+      (header_size + sizeof(T) + unit_alignment - 1u) / unit_alignment;
+
+  static inline void store(unit*, allocator_type const&, std::true_type) noexcept {}
+  static inline void store(unit* block, allocator_type const& allocator, std::false_type) {
+    new (static_cast<void*>(block)) allocator_type(allocator);
+  }
+
+  static inline allocator_type retrieve(unit*, std::true_type) noexcept { return {}; }
+  static inline allocator_type retrieve(unit* block, std::false_type) noexcept {
+    allocator_type* stored = reinterpret_cast<allocator_type*>(block);
+    allocator_type allocator{*stored};
+    stored->~allocator_type();
+    return allocator;
+  }
+
+  static inline counter_type& counter(T const* value) noexcept {
+    return *reinterpret_cast<counter_type*>(
+        const_cast<unsigned char*>(reinterpret_cast<unsigned char const*>(value)) - counter_size);
+  }
+
+  static inline void init_counter(T*, std::false_type) noexcept {}
+  static inline void init_counter(T* value, std::true_type) noexcept {
+    new (static_cast<void*>(&counter(value))) counter_type(1u);
+  }
+
+  // Returns true if the value is still referenced after the release
+  static inline bool release(T*, std::false_type) noexcept { return false; }
+  static inline bool release(T* value, std::true_type) noexcept {
+    return 1u != counter(value).fetch_sub(1u, std::memory_order_acq_rel);
+  }
+
+  static inline T* share(T const* value, std::false_type) { return create(*value); }
+  static inline T* share(T const* value, std::true_type) noexcept {
+    counter(value).fetch_add(1u, std::memory_order_relaxed);
+    return const_cast<T*>(value);
+  }
+
+  static inline bool is_unique(T const*, std::false_type) noexcept { return true; }
+  static inline bool is_unique(T const* value, std::true_type) noexcept {
+    return 1u == counter(value).load(std::memory_order_acquire);
+  }
+
+  static inline T* unique(T* value, std::false_type) noexcept { return value; }
+  static inline T* unique(T* value, std::true_type) {
+    if (1u == counter(value).load(std::memory_order_acquire)) return value;
+    T* copy = create(static_cast<T const&>(*value));
+    destroy(value);
+    return copy;
+  }
+
+ public:
+  template <class... Args>
+  static T* create(Args&&... args) {
+    allocator_type allocator;
+    unit* block = allocator_traits::allocate(allocator, units);
+    T* value = reinterpret_cast<T*>(reinterpret_cast<unsigned char*>(block) + header_size);
+    try {
+      new (static_cast<void*>(value)) T(std::forward<Args>(args)...);
+    } catch (...) {
+      allocator_traits::deallocate(allocator, block, units);
+      throw;
+    }
+    store(block, allocator, is_stateless{});
+    init_counter(value, is_shared{});
+    return value;
+  }
+
+  static void destroy(T* value) noexcept {
+    if (release(value, is_shared{})) return;
+    value->~T();
+    unit* block = reinterpret_cast<unit*>(reinterpret_cast<unsigned char*>(value) - header_size);
+    allocator_type allocator = retrieve(block, is_stateless{});
+    allocator_traits::deallocate(allocator, block, units);
+  }
+
+  // Returns a copy of value, or value itself once more referenced if shared
+  static T* share(T const* value) noexcept(Shared) { return share(value, is_shared{}); }
+
+  // Returns a value referenced only once, cloning value if it is shared
+  static T* unique(T* value) noexcept(!Shared) { return unique(value, is_shared{}); }
+
+  // Tells if value is referenced only once
+  static bool is_unique(T const* value) noexcept { return is_unique(value, is_shared{}); }
+};
+
 // deleter_fp is a function that deletes a type - small type version
-template <class T, class Impl, std::size_t MemSize>
-std::enable_if_t<store_on_stack<T, MemSize>::value, void> deleter_fp(void** data) {
-  reinterpret_cast<Impl*>(data)->~Impl();
+template <class T, class Impl, class Storage, class Allocation>
+std::enable_if_t<Storage::template is_inline<T>::value, void> deleter_fp(Storage& storage) {
+  static_cast<Impl*>(storage.template address<Impl>())->~Impl();
 }
 
 // deleter_fp is a function that deletes a type - big type version
-template <class T, class Impl, std::size_t MemSize>
-std::enable_if_t<!store_on_stack<T, MemSize>::value, void> deleter_fp(void** data) {
-  delete reinterpret_cast<Impl*>(*data);
+template <class T, class Impl, class Storage, class Allocation>
+std::enable_if_t<!Storage::template is_inline<T>::value, void> deleter_fp(Storage& storage) {
+  Allocation::destroy(static_cast<Impl*>(storage.pointer()));
+}
+
+//
+// switch_dispatch calls Applier::apply<T> with T the type at a runtime index of a type list
+//
+// Indices are matched in switches of 16 cases, chained for longer lists. Unlike
+// tables of function pointers, compilers turn them into jump tables without
+// any static initialization guard and may inline the applied functions.
+// The index must be lower than Size.
+//
+template <class Return, class TypeList, std::size_t Size, std::size_t Offset = 0>
+class switch_dispatch {
+ public:
+  static constexpr std::size_t chunk_size = 16u;
+
+ private:
+  template <std::size_t Index>
+  using type_at = typename TypeList::template type_at<(Index < Size ? Index : Size - 1u)>::type;
+
+  template <class Applier, class... Args>
+  static inline Return next(std::true_type, std::size_t index, Args&&... args) {
+    return switch_dispatch<Return, TypeList, Size, Offset + chunk_size>::template apply<Applier>(
+        index, std::forward<Args>(args)...);
+  }
+
+  template <class Applier, class... Args>
+  static inline Return next(std::false_type, std::size_t, Args&&... args) {
+    // Out of bounds, not supposed to happen
+    return Applier::template apply<type_at<Size - 1u>>(std::forward<Args>(args)...);
+  }
+
+ public:
+  template <class Applier, class... Args>
+  static inline Return apply(std::size_t index, Args&&... args) {
+#define JSON_BACKBONE_DISPATCH_CASE(N)                                                          \
+  case N:                                                                                       \
+    if (Offset + N < Size)                                                                      \
+      return Applier::template apply<type_at<Offset + N>>(std::forward<Args>(args)...);         \
+    break;
+    switch (index - Offset) {
+      JSON_BACKBONE_DISPATCH_CASE(0)
+      JSON_BACKBONE_DISPATCH_CASE(1)
+      JSON_BACKBONE_DISPATCH_CASE(2)
+      JSON_BACKBONE_DISPATCH_CASE(3)
+      JSON_BACKBONE_DISPATCH_CASE(4)
+      JSON_BACKBONE_DISPATCH_CASE(5)
+      JSON_BACKBONE_DISPATCH_CASE(6)
+      JSON_BACKBONE_DISPATCH_CASE(7)
+      JSON_BACKBONE_DISPATCH_CASE(8)
+      JSON_BACKBONE_DISPATCH_CASE(9)
+      JSON_BACKBONE_DISPATCH_CASE(10)
+      JSON_BACKBONE_DISPATCH_CASE(11)
+      JSON_BACKBONE_DISPATCH_CASE(12)
+      JSON_BACKBONE_DISPATCH_CASE(13)
+      JSON_BACKBONE_DISPATCH_CASE(14)
+      JSON_BACKBONE_DISPATCH_CASE(15)
+      default:
+        break;
+    }
+#undef JSON_BACKBONE_DISPATCH_CASE
+    return next<Applier>(std::integral_constant<bool, (Offset + chunk_size < Size)>{}, index,
+                         std::forward<Args>(args)...);
+  }
+};
+
+//
+// table_dispatch calls Applier::apply<T> through a constant table of function pointers
+//
+// Used for long type lists, such as the combinations of types of several
+// variants, which switch_dispatch would match through a chain of switches.
+// The table is constant initialized, the call is a single indirect jump.
+// The index must be lower than the size of the list.
+//
+template <class Return, class TypeList, class Indices = std::make_index_sequence<TypeList::size>>
+struct table_dispatch;
+template <class Return, class TypeList, std::size_t... Index>
+struct table_dispatch<Return, TypeList, std::index_sequence<Index...>> {
+  template <class Applier, class T, class... Args>
+  static Return call(Args&&... args) {
+    return Applier::template apply<T>(std::forward<Args>(args)...);
+  }
+
+  template <class Applier, class... Args>
+  static inline Return apply(std::size_t index, Args&&... args) {
+    using function = Return (*)(Args&&...);
+    static constexpr function table[] = {
+        &call<Applier, typename TypeList::template type_at<Index>::type, Args...>...};
+    return table[index](std::forward<Args>(args)...);
+  }
+};
+
+// dispatch applies Applier to the type of a variant
+template <class Return, class Applier, class Variant, class... Args>
+inline Return dispatch(Variant const& value, Args&&... args) {
+  using type_list = typename Variant::type_list_t;
+  return switch_dispatch<Return, type_list, type_list::size>::template apply<Applier>(
+      value.type_index(), std::forward<Args>(args)...);
 }
 
 }  // namespace helpers
@@ -382,28 +1129,109 @@ struct completeness_test {
   static constexpr bool value = T::test_complete;
 };
 
+namespace helpers {
+// is_trivially_storable tells if a type is stored inline and copied and destroyed trivially
+template <class Storage, class T>
+struct is_trivially_storable
+    : std::conditional_t<Storage::template is_inline<T>::value,
+                         std::integral_constant<bool, std::is_trivially_copyable<T>::value &&
+                                                          std::is_trivially_destructible<T>::value>,
+                         std::false_type> {};
+
+//
+// variant_base holds the storage of a variant and defines its special member functions
+//
+// When every bounded type is trivially storable, the trivial version makes the
+// variant trivially copyable and destructible. Otherwise they dispatch to the
+// static operations of the variant.
+//
+template <class Variant, class Storage, bool Trivial, class... Value>
+class variant_base {
+ protected:
+  Storage storage_;
+};
+
+template <class Variant, class Storage, class... Value>
+class variant_base<Variant, Storage, false, Value...> {
+ protected:
+  Storage storage_;
+
+ public:
+  variant_base() = default;
+
+  variant_base(variant_base const& other) noexcept(arithmetics::all_equals<bool, sizeof...(Value)>(
+      {std::is_nothrow_copy_constructible<Value>::value...}, true)) {
+    Variant::copy_construct(storage_, other.storage_);
+  }
+
+  variant_base(variant_base&& other) noexcept(arithmetics::all_equals<bool, sizeof...(Value)>(
+      {std::is_nothrow_move_constructible<Value>::value...}, true)) {
+    Variant::move_construct(storage_, other.storage_);
+  }
+
+  variant_base& operator=(variant_base const& other) noexcept(
+      arithmetics::all_equals<bool, sizeof...(Value)>(
+          {std::is_nothrow_copy_assignable<Value>::value...}, true)) {
+    Variant::copy_assign(storage_, other.storage_);
+    return *this;
+  }
+
+  variant_base& operator=(variant_base&& other) noexcept(
+      arithmetics::all_equals<bool, sizeof...(Value)>(
+          {std::is_nothrow_move_assignable<Value>::value...}, true)) {
+    Variant::move_assign(storage_, other.storage_);
+    return *this;
+  }
+
+  ~variant_base() { Variant::destroy(storage_); }
+};
+
+template <class... Value>
+using variant_storage_t = typename variant_traits<Value...>::layout::template storage<
+    variant_traits<Value...>, Value...>;
+
+template <class Variant, class... Value>
+using variant_base_t = variant_base<
+    Variant, variant_storage_t<Value...>,
+    arithmetics::all_equals<bool, sizeof...(Value)>(
+        {is_trivially_storable<variant_storage_t<Value...>, Value>::value...}, true),
+    Value...>;
+}  // namespace helpers
+
 //
 // variant is a discriminated union optimized for small types
 //
+// It is trivially copyable and destructible when its types are all stored
+// inline and are themselves trivially copyable and destructible.
+//
 template <class... Value>
-class variant {
+class variant : private helpers::variant_base_t<variant<Value...>, Value...> {
+  using base_type = helpers::variant_base_t<variant<Value...>, Value...>;
+  template <class, class, bool, class...>
+  friend class helpers::variant_base;
+
   // Helpers for auto-detection of recrusive types. Broken on Clang
   static constexpr bool test_complete = arithmetics::all_equals<bool, sizeof...(Value)>(
       {(is_complete<Value>::value || true)...}, true);
   friend struct completeness_test<variant>;
 
-  // Compute minimum size required by types. Default 8
-  static constexpr std::size_t min_memory_size =
-      arithmetics::max_value<std::size_t, sizeof...(Value)>({memory_footprint<Value>::value...});
-
  public:
-  // Compute memory size of an array of void* wide enough to hold min_memory_size
-  static constexpr std::size_t memory_size =
-      sizeof(void*) * (min_memory_size / sizeof(void*) + (min_memory_size % sizeof(void*) ? 1 : 0));
+  // Storage policies
+  using traits_type = variant_traits<Value...>;
+  using index_type = typename traits_type::index_type;
+  static_assert(std::is_unsigned<index_type>::value &&
+                    sizeof...(Value) <= std::numeric_limits<index_type>::max(),
+                "index_type must be unsigned and wide enough to hold every type index.");
+  using layout_type = typename traits_type::layout;
+  using storage_type = typename layout_type::template storage<traits_type, Value...>;
+  using allocator_type = typename traits_type::allocator_type;
+
+  // Memory size and alignment of the storage
+  static constexpr std::size_t memory_size = storage_type::memory_size;
+  static constexpr std::size_t alignment = storage_type::alignment;
 
  private:
-  std::size_t type_ = sizeof...(Value);
-  void* data_[memory_size / sizeof(void*)] = {};
+  using base_type::storage_;
 
  public:
   // Original list of types kept to know wether a type is recursive or not
@@ -431,7 +1259,7 @@ class variant {
         std::integral_constant<std::size_t,
                                target_type_list_t::template get_index<std::decay_t<target_type>>()>;
     using type = typename type_list_t::template type_at<type_index::value>::type;
-    using on_stack_type = store_on_stack<type, memory_size>;
+    using on_stack_type = typename storage_type::template is_inline<type>;
   };
 
   using default_type = typename target_type_list_t::template type_at<
@@ -442,58 +1270,277 @@ class variant {
   template <class T, class Return>
   using enable_if_heap_t = std::enable_if_t<!resolve_type<T>::on_stack_type::value, Return>;
 
-  //
-  // Destroys currently held object and deallocates heap if needed
-  //
-  void clear() {
-    static std::array<void (*)(void**), sizeof...(Value)> deleters = {
-        helpers::deleter_fp<Value, bounded_identity_t<Value>, memory_size>...};
-    if (type_ < sizeof...(Value))  // Should always be the case
-      deleters[type_](&data_[0]);
+  // Heap values are shared between copies under copy on write
+  using shares_heap = std::integral_constant<bool, traits_type::copy_on_write>;
+
+  template <class T>
+  using allocation_t = helpers::heap_allocation<T, allocator_type, shares_heap::value>;
+
+  // Dispatches a call to Applier on the type at index
+  template <class Return, class Applier, class... Args>
+  static inline Return dispatch(std::size_t index, Args&&... args) {
+    return helpers::switch_dispatch<Return, type_list_t, sizeof...(Value)>::template apply<
+        Applier>(index, std::forward<Args>(args)...);
   }
 
-  template <class T, class Arg, class... Args>
-  enable_if_stack_t<T, void> allocate(Arg&& arg, Args&&... args) {
-    new (reinterpret_cast<T*>(&data_[0])) T(std::forward<Arg>(arg), std::forward<Args>(args)...);
+  // Returns the address of a value held by a storage
+  template <class T>
+  static inline enable_if_stack_t<T, T*> address_of(storage_type& storage) noexcept {
+    return static_cast<T*>(storage.template address<T>());
   }
 
-  template <class T, class Arg, class... Args>
-  enable_if_heap_t<T, void> allocate(Arg&& arg, Args&&... args) {
-    T** ptr = reinterpret_cast<T**>(&data_[0]);
-    *ptr = new T(std::forward<Arg>(arg), std::forward<Args>(args)...);
+  // Heap values shared with copy on write are cloned on mutable access
+  template <class T>
+  static inline enable_if_heap_t<T, T*> address_of(storage_type& storage) noexcept(
+      !shares_heap::value) {
+    T* value = static_cast<T*>(storage.pointer());
+    T* unique = allocation_t<T>::unique(value);
+    if (unique != value) storage.set_pointer(unique, resolve_type<T>::type_index::value);
+    return unique;
   }
 
-  template <class Arg, class... Args>
-  void create(Arg&& arg, Args&&... args) {
-    using target_type =
-        typename target_type_list_t::template select_constructible<memory_size, Arg, Args...>::type;
-    assert_has_type<target_type>();
-    using resolved_type = resolve_type<target_type>;
-    type_ = resolved_type::type_index::value;
-    allocate<target_type>(std::forward<Arg>(arg), std::forward<Args>(args)...);
+  template <class T>
+  static inline enable_if_stack_t<T, T const*> address_of(storage_type const& storage) noexcept {
+    return static_cast<T const*>(storage.template address<T>());
   }
 
   template <class T>
-  static void copy_ctor_fp(variant& self, variant const& other) {
-    self.create(other.template raw<bounded_identity_t<T>>());
+  static inline enable_if_heap_t<T, T const*> address_of(storage_type const& storage) noexcept {
+    return static_cast<T const*>(storage.pointer());
+  }
+
+  template <class T, class... Args>
+  static enable_if_stack_t<T, void> allocate(storage_type& storage, Args&&... args) {
+    new (storage.template address<T>()) T(std::forward<Args>(args)...);
+    storage.set_index(resolve_type<T>::type_index::value);
+  }
+
+  template <class T, class... Args>
+  static enable_if_heap_t<T, void> allocate(storage_type& storage, Args&&... args) {
+    storage.set_pointer(allocation_t<T>::create(std::forward<Args>(args)...),
+                        resolve_type<T>::type_index::value);
+  }
+
+  // Replaces the held value with a T built from args, once it is built
+  template <class T, class... Args>
+  enable_if_heap_t<T, void> replace(Args&&... args) {
+    T* value = allocation_t<T>::create(std::forward<Args>(args)...);
+    clear();
+    storage_.set_pointer(value, resolve_type<T>::type_index::value);
+  }
+
+  template <class T, class... Args>
+  enable_if_stack_t<T, void> replace(Args&&... args) {
+    replace_inline<T>(std::is_nothrow_constructible<T, Args...>{}, std::forward<Args>(args)...);
+  }
+
+  template <class T, class... Args>
+  void replace_inline(std::true_type, Args&&... args) {
+    clear();
+    allocate<T>(storage_, std::forward<Args>(args)...);
+  }
+
+  template <class T, class... Args>
+  void replace_inline(std::false_type, Args&&... args) {
+    T value(std::forward<Args>(args)...);
+    clear();
+    allocate<T>(storage_, std::move(value));
+  }
+
+  // Assigns a converted value in place if possible
+  template <class Target, class T>
+  void assign_converted(T&& value, std::true_type) {
+    if (storage_.index() == target_type_list_t::template get_index<Target>()) {
+      *address_of<Target>(storage_) = std::forward<T>(value);
+    } else {
+      emplace<Target>(std::forward<T>(value));
+    }
+  }
+
+  template <class Target, class T>
+  void assign_converted(T&& value, std::false_type) {
+    emplace<Target>(std::forward<T>(value));
+  }
+
+  // Copies a value of other in an empty storage, sharing heap values with copy on write
+  template <class T>
+  static enable_if_stack_t<T, void> copy_value(storage_type& self, storage_type const& other) {
+    construct(self, *address_of<T>(other));
+  }
+
+  template <class T>
+  static enable_if_heap_t<T, void> copy_value(storage_type& self, storage_type const& other) {
+    self.set_pointer(allocation_t<T>::share(address_of<T>(other)),
+                     resolve_type<T>::type_index::value);
+  }
+
+  // Tells if the default type can replace a heap value stolen from a storage
+  template <class T, bool = std::is_void<T>::value>
+  struct is_resettable : std::false_type {};
+  template <class T>
+  struct is_resettable<T, false>
+      : std::integral_constant<bool, resolve_type<T>::on_stack_type::value &&
+                                         std::is_nothrow_default_constructible<T>::value> {};
+
+  // Hands the heap value of other over to self, other then holding the default type
+  template <class T>
+  static void steal_value(storage_type& self, storage_type& other, std::true_type) noexcept {
+    self.set_pointer(other.pointer(), resolve_type<T>::type_index::value);
+    allocate<default_type>(other);
+  }
+
+  // Without an inline default type to leave in other, the value is shared
+  template <class T>
+  static void steal_value(storage_type& self, storage_type& other, std::false_type) noexcept {
+    copy_value<T>(self, other);
+  }
+
+  // Moves a value of other in an empty storage, stealing heap values with copy on write
+  template <class T>
+  static void move_value(storage_type& self, storage_type& other, std::false_type) {
+    construct(self, std::move(*address_of<T>(other)));
   }
 
   template <class T>
-  static void move_ctor_fp(variant& self, variant&& other) {
-    self.create(std::move(other.template raw<bounded_identity_t<T>>()));
+  static enable_if_stack_t<T, void> move_value(storage_type& self, storage_type& other,
+                                               std::true_type) {
+    construct(self, std::move(*address_of<T>(other)));
   }
 
   template <class T>
-  static void copy_assign_fp(variant& self, variant const& other) {
-    self.template get<bounded_identity_t<T>>() = other.template raw<bounded_identity_t<T>>();
+  static enable_if_heap_t<T, void> move_value(storage_type& self, storage_type& other,
+                                              std::true_type) {
+    steal_value<T>(self, other, is_resettable<default_type>{});
   }
 
+  // Assigns a value of other to the value of the same type in self
   template <class T>
-  static void move_assign_fp(variant& self, variant&& other) {
-    self.template get<bounded_identity_t<T>>() =
-        std::move(other.template raw<bounded_identity_t<T>>());
+  static void copy_assign_value(storage_type& self, storage_type const& other, std::false_type) {
+    *address_of<T>(self) = *address_of<T>(other);
+  }
+
+  template <class T>
+  static enable_if_stack_t<T, void> copy_assign_value(storage_type& self,
+                                                      storage_type const& other, std::true_type) {
+    *address_of<T>(self) = *address_of<T>(other);
+  }
+
+  template <class T>
+  static enable_if_heap_t<T, void> copy_assign_value(storage_type& self,
+                                                     storage_type const& other, std::true_type) {
+    T* previous = static_cast<T*>(self.pointer());
+    copy_value<T>(self, other);
+    allocation_t<T>::destroy(previous);
+  }
+
+  template <class T>
+  static void move_assign_value(storage_type& self, storage_type& other, std::false_type) {
+    *address_of<T>(self) = std::move(*address_of<T>(other));
+  }
+
+  template <class T>
+  static enable_if_stack_t<T, void> move_assign_value(storage_type& self, storage_type& other,
+                                                      std::true_type) {
+    *address_of<T>(self) = std::move(*address_of<T>(other));
+  }
+
+  template <class T>
+  static enable_if_heap_t<T, void> move_assign_value(storage_type& self, storage_type& other,
+                                                     std::true_type) {
+    if (&self == &other) return;
+    T* previous = static_cast<T*>(self.pointer());
+    move_value<T>(self, other, std::true_type{});
+    allocation_t<T>::destroy(previous);
+  }
+
+  // Constructs the bounded type constructible from the arguments in an empty storage
+  template <class Arg, class... Args>
+  static void construct(storage_type& storage, Arg&& arg, Args&&... args) {
+    using target_type =
+        typename target_type_list_t::template select_constructible<memory_size, Arg, Args...>::type;
+    assert_has_type<target_type>();
+    allocate<target_type>(storage, std::forward<Arg>(arg), std::forward<Args>(args)...);
+  }
+
+  template <class Arg, class... Args>
+  void create(Arg&& arg, Args&&... args) {
+    construct(storage_, std::forward<Arg>(arg), std::forward<Args>(args)...);
   }
 
+  // Appliers used with dispatch
+  struct deleter {
+    template <class T>
+    static void apply(storage_type& storage) {
+      helpers::deleter_fp<T, bounded_identity_t<T>, storage_type,
+                          allocation_t<bounded_identity_t<T>>>(storage);
+    }
+  };
+
+  struct copy_constructor {
+    template <class T>
+    static void apply(storage_type& self, storage_type const& other) {
+      copy_value<bounded_identity_t<T>>(self, other);
+    }
+  };
+
+  struct move_constructor {
+    template <class T>
+    static void apply(storage_type& self, storage_type& other) {
+      move_value<bounded_identity_t<T>>(self, other, shares_heap{});
+    }
+  };
+
+  struct copy_assigner {
+    template <class T>
+    static void apply(storage_type& self, storage_type const& other) {
+      copy_assign_value<bounded_identity_t<T>>(self, other, shares_heap{});
+    }
+  };
+
+  struct move_assigner {
+    template <class T>
+    static void apply(storage_type& self, storage_type& other) {
+      move_assign_value<bounded_identity_t<T>>(self, other, shares_heap{});
+    }
+  };
+
+  // Special member functions of non trivial variants, called by variant_base
+  static void destroy(storage_type& storage) {
+    if (storage.index() < sizeof...(Value))  // Should always be the case
+      dispatch<void, deleter>(storage.index(), storage);
+  }
+
+  static void copy_construct(storage_type& self, storage_type const& other) {
+    dispatch<void, copy_constructor>(other.index(), self, other);
+  }
+
+  static void move_construct(storage_type& self, storage_type& other) {
+    dispatch<void, move_constructor>(other.index(), self, other);
+  }
+
+  static void copy_assign(storage_type& self, storage_type const& other) {
+    if (self.index() == other.index()) {
+      dispatch<void, copy_assigner>(other.index(), self, other);
+    } else {
+      destroy(self);
+      copy_construct(self, other);
+    }
+  }
+
+  static void move_assign(storage_type& self, storage_type& other) {
+    if (self.index() == other.index()) {
+      dispatch<void, move_assigner>(other.index(), self, other);
+    } else {
+      destroy(self);
+      move_construct(self, other);
+    }
+  }
+
+  //
+  // Destroys currently held object and deallocates heap if needed
+  //
+  void clear() { destroy(storage_); }
+
  public:
   // Template resolution must work event with incomplete types here
   template <bool HasDefault = (bounded_traits_t::select_default::index_value < sizeof...(Value)),
@@ -502,19 +1549,9 @@ class variant {
     create(default_type());
   }
 
-  variant(variant const& other) noexcept(arithmetics::all_equals<bool, sizeof...(Value)>(
-      {std::is_nothrow_copy_constructible<Value>::value...}, true)) {
-    static std::array<void (*)(variant&, variant const&), sizeof...(Value)> ctors = {
-        copy_ctor_fp<Value>...};
-    ctors[other.type_](*this, other);
-  }
-
-  variant(variant&& other) noexcept(arithmetics::all_equals<bool, sizeof...(Value)>(
-      {std::is_nothrow_move_constructible<Value>::value...}, true)) {
-    static std::array<void (*)(variant&, variant&&), sizeof...(Value)> ctors = {
-        move_ctor_fp<Value>...};
-    ctors[other.type_](*this, std::move(other));
-  }
+  // Copy, move and destruction are defined by variant_base
+  variant(variant const& other) = default;
+  variant(variant&& other) = default;
 
   // Construction with a compatible constructor from a bounded type
   template <
@@ -531,49 +1568,18 @@ class variant {
         "Construction not supported by the variant.");
     using target_type =
         typename target_type_list_t::template select_constructible<memory_size, Arg, Args...>::type;
-    assert_has_type<target_type>();
-    create(std::forward<Arg>(arg), std::forward<Args>(args)...);
-  }
-
-  // Non-virtual destructor to spare a useless virtual table
-  ~variant() { clear(); }
-
-  // Assign from other variant
-  variant& operator=(variant const& other) noexcept(arithmetics::all_equals<bool, sizeof...(Value)>(
-      {std::is_nothrow_copy_assignable<Value>::value...}, true)) {
-    static std::array<void (*)(variant&, variant const&), sizeof...(Value)> stores = {
-        copy_assign_fp<Value>...};
-
-    static std::array<void (*)(variant&, variant const&), sizeof...(Value)> ctors = {
-        copy_ctor_fp<Value>...};
-
-    if (type_ == other.type_) {
-      stores[type_](*this, other);
-    } else {
-      clear();
-      ctors[other.type_](*this, other);
-    }
-    return *this;
+    assert_has_type<target_type>();
+    create(std::forward<Arg>(arg), std::forward<Args>(args)...);
   }
 
-  variant& operator=(variant&& other) noexcept(arithmetics::all_equals<bool, sizeof...(Value)>(
-      {std::is_nothrow_move_assignable<Value>::value...}, true)) {
-    static std::array<void (*)(variant&, variant&&), sizeof...(Value)> stores = {
-        move_assign_fp<Value>...};
-
-    static std::array<void (*)(variant&, variant&&), sizeof...(Value)> ctors = {
-        move_ctor_fp<Value>...};
+  // Non-virtual destructor to spare a useless virtual table
+  ~variant() = default;
 
-    if (type_ == other.type_) {
-      stores[type_](*this, std::move(other));
-    } else {
-      clear();
-      ctors[other.type_](*this, std::move(other));
-    }
-    return *this;
-  }
+  // Assign from other variant
+  variant& operator=(variant const& other) = default;
+  variant& operator=(variant&& other) = default;
 
-  inline size_t type_index() const { return type_; }
+  inline size_t type_index() const { return storage_.index(); }
 
   template <class T>
   static constexpr size_t type_index() {
@@ -586,7 +1592,7 @@ class variant {
                          target_type_list_t::template has_type<std::decay_t<T>>(), void>>
   variant& assign(T&& value) {
     assert_has_type<std::decay_t<T>>();
-    if (type_ == target_type_list_t::template get_index<std::decay_t<T>>()) {
+    if (storage_.index() == target_type_list_t::template get_index<std::decay_t<T>>()) {
       raw<std::decay_t<T>>() = std::forward<T>(value);
     } else {
       clear();
@@ -605,8 +1611,22 @@ class variant {
     static_assert(target_type_list_t::template select_constructible<memory_size, T>::index_value <
                       sizeof...(Value),
                   "Assignation not supported by the variant.");
-    return assign(typename target_type_list_t::template select_constructible<memory_size, T>::type{
-        std::forward<T>(value)});
+    using target_type =
+        typename target_type_list_t::template select_constructible<memory_size, T>::type;
+    assign_converted<target_type>(std::forward<T>(value),
+                                  std::is_assignable<target_type&, T>{});
+    return *this;
+  }
+
+  // Destroys the held value and constructs a T from the arguments directly in the variant
+  //
+  // The new value is built before the held one is destroyed, the variant is left
+  // untouched if its constructor throws.
+  template <class T, class... Args>
+  T& emplace(Args&&... args) {
+    assert_has_type<T>();
+    replace<T>(std::forward<Args>(args)...);
+    return *address_of<T>(storage_);
   }
 
   // Assignation operators dispatches call on the matching assign.
@@ -619,14 +1639,14 @@ class variant {
   template <class T>
   inline bool is() const noexcept {
     assert_has_type<T>();
-    return type_ == target_type_list_t::template get_index<T>();
+    return storage_.holds(target_type_list_t::template get_index<T>());
   }
 
   // get checks the type is correct and returns it
   template <class T>
   enable_if_stack_t<T, T&> get() & {
     assert_has_type<T>();
-    if (is<T>()) return *(reinterpret_cast<T*>(&data_[0]));
+    if (is<T>()) return *(static_cast<T*>(storage_.template address<T>()));
     throw bad_variant_access{"Bad variant type in get."};
   }
 
@@ -634,7 +1654,7 @@ class variant {
   template <class T>
   enable_if_heap_t<T, T&> get() & {
     assert_has_type<T>();
-    if (is<T>()) return *(reinterpret_cast<T*>(data_[0]));
+    if (is<T>()) return *address_of<T>(storage_);
     throw bad_variant_access{"Bad variant type in get."};
   }
 
@@ -642,7 +1662,7 @@ class variant {
   template <class T>
   enable_if_stack_t<T, T const&> get() const & {
     assert_has_type<T>();
-    if (is<T>()) return *(reinterpret_cast<T const*>(&data_[0]));
+    if (is<T>()) return *(static_cast<T const*>(storage_.template address<T>()));
     throw bad_variant_access{"Bad variant type in get."};
   }
 
@@ -650,7 +1670,7 @@ class variant {
   template <class T>
   enable_if_heap_t<T, T const&> get() const & {
     assert_has_type<T>();
-    if (is<T>()) return *(reinterpret_cast<T const*>(data_[0]));
+    if (is<T>()) return *(static_cast<T const*>(storage_.pointer()));
     throw bad_variant_access{"Bad variant type in get."};
   }
 
@@ -658,7 +1678,7 @@ class variant {
   template <class T>
   enable_if_stack_t<T, T> get() && {
     assert_has_type<T>();
-    if (is<T>()) return std::move(*(reinterpret_cast<T*>(&data_[0])));
+    if (is<T>()) return std::move(*(static_cast<T*>(storage_.template address<T>())));
     throw bad_variant_access{"Bad variant type in get."};
   }
 
@@ -666,7 +1686,7 @@ class variant {
   template <class T>
   enable_if_heap_t<T, T> get() && {
     assert_has_type<T>();
-    if (is<T>()) return std::move(*(reinterpret_cast<T*>(data_[0])));
+    if (is<T>()) return std::move(*address_of<T>(storage_));
     throw bad_variant_access{"Bad variant type in get."};
   }
 
@@ -674,42 +1694,58 @@ class variant {
   template <class T>
       inline enable_if_stack_t<T, T&> raw() & noexcept {
     assert_has_type<T>();
-    return *(reinterpret_cast<T*>(&data_[0]));
+    return *(static_cast<T*>(storage_.template address<T>()));
   }
 
   // raw returns directly without any runtime check
   template <class T>
-      inline enable_if_heap_t<T, T&> raw() & noexcept {
+      inline enable_if_heap_t<T, T&> raw() & noexcept(!shares_heap::value) {
     assert_has_type<T>();
-    return *(reinterpret_cast<T*>(data_[0]));
+    return *address_of<T>(storage_);
   }
 
   // raw returns directly without any runtime check
   template <class T>
   inline enable_if_stack_t<T, T const&> raw() const& noexcept {
     assert_has_type<T>();
-    return *(reinterpret_cast<T const*>(&data_[0]));
+    return *(static_cast<T const*>(storage_.template address<T>()));
   }
 
   // raw returns directly without any runtime check
   template <class T>
   inline enable_if_heap_t<T, T const&> raw() const& noexcept {
     assert_has_type<T>();
-    return *(reinterpret_cast<T const*>(data_[0]));
+    return *(static_cast<T const*>(storage_.pointer()));
   }
 
   // raw returns directly without any runtime check
   template <class T>
       inline enable_if_stack_t<T, T> raw() && noexcept {
     assert_has_type<T>();
-    return std::move(*(reinterpret_cast<T*>(&data_[0])));
+    return std::move(*(static_cast<T*>(storage_.template address<T>())));
   }
 
   // raw returns directly without any runtime check
   template <class T>
-      inline enable_if_heap_t<T, T> raw() && noexcept {
+      inline enable_if_heap_t<T, T> raw() && noexcept(!shares_heap::value) {
     assert_has_type<T>();
-    return std::move(*(reinterpret_cast<T*>(data_[0])));
+    return std::move(*address_of<T>(storage_));
+  }
+
+  // Returns the value if it has type T and is not shared with copies, nullptr otherwise
+  template <class T>
+  enable_if_stack_t<T, T*> get_if_unique() noexcept {
+    assert_has_type<T>();
+    return is<T>() ? static_cast<T*>(storage_.template address<T>()) : nullptr;
+  }
+
+  // Returns the value if it has type T and is not shared with copies, nullptr otherwise
+  template <class T>
+  enable_if_heap_t<T, T*> get_if_unique() noexcept {
+    assert_has_type<T>();
+    if (!is<T>()) return nullptr;
+    T* value = static_cast<T*>(storage_.pointer());
+    return allocation_t<T>::is_unique(value) ? value : nullptr;
   }
 
   // Conversion operator
@@ -774,28 +1810,178 @@ inline decltype(auto) raw(variant<Value...>&& value) noexcept {
   return std::move(value.template raw<T>());
 }
 
+//
+// is_transparent detects comparators and hashers accepting any comparable type
+//
+// They declare an is_transparent member type, as std::less<> does.
+//
+template <class T, class Enabler = void>
+struct is_transparent : std::false_type {};
+template <class T>
+struct is_transparent<T, std::conditional_t<true, void, typename T::is_transparent>>
+    : std::true_type {};
+
+//
+// has_transparent_lookup tells if an object type finds keys without converting them
+//
+// Ordered objects need a transparent key_compare, hashed objects need both a
+// transparent hasher and key_equal. Lookups in such objects through container and
+// view operator[] never build a temporary key.
+//
+template <class Object, class Enabler = void>
+struct has_transparent_lookup : std::false_type {};
+template <class Object>
+struct has_transparent_lookup<
+    Object, std::conditional_t<true, void, typename Object::key_compare>>
+    : is_transparent<typename Object::key_compare> {};
+template <class Object>
+struct has_transparent_lookup<
+    Object, std::conditional_t<true, void, std::pair<typename Object::hasher,
+                                                     typename Object::key_equal>>>
+    : std::integral_constant<bool, is_transparent<typename Object::hasher>::value &&
+                                       is_transparent<typename Object::key_equal>::value> {};
+
+//
+// transparent_object_t gives ordered objects comparing keys with std::less<Key> a std::less<>
+//
+// std::map and the maps with the same parameters are thus transparent when used
+// as the ObjectBase of a container, and find keys of any comparable type, such as
+// character strings for std::string keys, without converting them. Elements keep
+// the same order. Other object types are left unchanged.
+//
+template <class Object>
+struct transparent_object {
+  using type = Object;
+};
+template <template <class...> class Object, class Key, class Value, class Allocator>
+struct transparent_object<Object<Key, Value, std::less<Key>, Allocator>> {
+  using type = Object<Key, Value, std::less<>, Allocator>;
+};
+template <class Object>
+using transparent_object_t = typename transparent_object<Object>::type;
+
+//
+// key_lookup finds the key_type value read-only lookups search for
+//
+// Specializations declare static find functions taking the types keys are looked
+// up with. Unlike conversions to the key_type, they need not register the key
+// anywhere: json_backbone/symbol.hpp looks strings up in its symbol table without
+// interning them. They take precedence over transparent lookup.
+//
+template <class Key>
+struct key_lookup {};
+
+namespace helpers {
+// Overload ranking, higher ranks are preferred
+template <std::size_t N>
+struct rank : rank<N - 1u> {};
+template <>
+struct rank<0u> {};
+
+template <class Object, class T,
+          class Enabler = std::enable_if_t<
+              std::is_same<std::decay_t<T>, typename Object::key_type>::value, void>>
+inline T&& lookup_key(T&& value, rank<3u>) noexcept {
+  return std::forward<T>(value);
+}
+
+template <class Object, class T>
+inline auto lookup_key(T&& value, rank<2u>)
+    -> decltype(key_lookup<typename Object::key_type>::find(std::forward<T>(value))) {
+  return key_lookup<typename Object::key_type>::find(std::forward<T>(value));
+}
+
+template <class Object, class T,
+          class Enabler = std::enable_if_t<has_transparent_lookup<Object>::value, void>>
+inline T&& lookup_key(T&& value, rank<1u>) noexcept {
+  return std::forward<T>(value);
+}
+
+template <class Object, class T>
+inline typename Object::key_type lookup_key(T&& value, rank<0u>) {
+  return typename Object::key_type(std::forward<T>(value));
+}
+
+// Returns the key read-only lookups in Object pass to find
+template <class Object, class T>
+inline decltype(auto) lookup_key(T&& value) {
+  return lookup_key<Object>(std::forward<T>(value), rank<3u>{});
+}
+}  // namespace helpers
+
 //
 // container is a variant extended with an associative container and a random access container
 //
 template <template <class...> class ObjectBase, template <class...> class ArrayBase, class Key,
           class... Value>
 class container
-    : public variant<Value..., ArrayBase<container<ObjectBase, ArrayBase, Key, Value...>>,
-                     ObjectBase<Key, container<ObjectBase, ArrayBase, Key, Value...>>> {
+    : public variant<
+          Value..., ArrayBase<container<ObjectBase, ArrayBase, Key, Value...>>,
+          transparent_object_t<ObjectBase<Key, container<ObjectBase, ArrayBase, Key, Value...>>>> {
  public:
-  using variant_type = variant<Value..., ArrayBase<container<ObjectBase, ArrayBase, Key, Value...>>,
-                               ObjectBase<Key, container<ObjectBase, ArrayBase, Key, Value...>>>;
-  using object_type = ObjectBase<Key, container>;
+  using variant_type = variant<
+      Value..., ArrayBase<container<ObjectBase, ArrayBase, Key, Value...>>,
+      transparent_object_t<ObjectBase<Key, container<ObjectBase, ArrayBase, Key, Value...>>>>;
+  using object_type = transparent_object_t<ObjectBase<Key, container>>;
   using array_type = ArrayBase<container>;
   using key_type = Key;
   using value_type_list_type =
       type_list_traits::type_list<std::make_index_sequence<sizeof...(Value)>, Value...>;
 
+ private:
+  struct collections {
+    std::vector<array_type> arrays;
+    std::vector<object_type> objects;
+  };
+
+  // Moves the collection held by value to the worklist, unless it is empty or shared
+  static void detach(container& value, collections& worklist) {
+    if (array_type* array = value.template get_if_unique<array_type>()) {
+      if (!array->empty()) worklist.arrays.push_back(std::move(*array));
+    } else if (object_type* object = value.template get_if_unique<object_type>()) {
+      if (!object->empty()) worklist.objects.push_back(std::move(*object));
+    }
+  }
+
+  //
+  // Destroys nested collections iteratively rather than recursively
+  //
+  // Collections are detached onto a worklist before their parent is destroyed,
+  // so that each one is destroyed with flat children only. Deeply nested
+  // containers are thus destroyed without overflowing the call stack. Should the
+  // worklist fail to allocate, the remaining collections are destroyed recursively.
+  //
+  void tear_down() noexcept {
+    try {
+      collections worklist;
+      detach(*this, worklist);
+      while (!worklist.arrays.empty() || !worklist.objects.empty()) {
+        if (!worklist.arrays.empty()) {
+          array_type array = std::move(worklist.arrays.back());
+          worklist.arrays.pop_back();
+          for (auto& element : array) detach(element, worklist);
+        } else {
+          object_type object = std::move(worklist.objects.back());
+          worklist.objects.pop_back();
+          for (auto& element : object) detach(element.second, worklist);
+        }
+      }
+    } catch (...) {
+    }
+  }
+
+ public:
   container() : variant_type{} {}
 
   container(container const& value) : variant_type(value) {}
 
-  container(container&& value) : variant_type(std::move(value)) {}
+  // Moves as the variant does, so that arrays of containers move their elements when growing
+  container(container&& value) noexcept(std::is_nothrow_move_constructible<variant_type>::value)
+      : variant_type(std::move(value)) {}
+
+  ~container() {
+    if (this->template is<array_type>() || this->template is<object_type>()) tear_down();
+  }
 
   template <class Arg, class... Args>
   container(Arg&& arg, Args&&... args)
@@ -866,8 +2052,9 @@ class container
     if (!this->template is<object_type>())
       throw bad_container_object_access(
           "Bad container access in operator[](Key), container is not an object.");
-    auto it = this->template get<object_type>().find(std::forward<T>(value));
-    if (it != this->template get<object_type>().end()) { return it->second; }
+    object_type const& object = this->template get<object_type>();
+    auto it = object.find(helpers::lookup_key<object_type>(std::forward<T>(value)));
+    if (it != object.end()) { return it->second; }
     throw bad_container_object_access(
         "Bad container access in operator[](Key), no element at this key.");
   }
@@ -879,6 +2066,30 @@ class container
           "Bad container access in operator[](Key), container is not an object.");
     return std::move(this->template get<object_type>()[std::forward<T>(value)]);
   }
+
+  // Constructs an element at the end of the array directly from the arguments
+  template <class... Args>
+  container& emplace_back(Args&&... args) {
+    if (!this->template is<array_type>())
+      throw bad_container_array_access(
+          "Bad container access in emplace_back, container is not an array.");
+    array_type& array = this->template get<array_type>();
+    array.emplace_back(std::forward<Args>(args)...);
+    return array.back();
+  }
+
+  // Constructs an element at key directly from the arguments, unless key already exists
+  template <class K, class... Args>
+  std::pair<typename object_type::iterator, bool> try_emplace(K&& key, Args&&... args) {
+    if (!this->template is<object_type>())
+      throw bad_container_object_access(
+          "Bad container access in try_emplace, container is not an object.");
+    object_type& object = this->template get<object_type>();
+    auto it = object.find(helpers::lookup_key<object_type>(key));
+    if (it != object.end()) return {it, false};
+    return object.emplace(std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)),
+                          std::forward_as_tuple(std::forward<Args>(args)...));
+  }
 };
 
 namespace helpers {
@@ -888,17 +2099,37 @@ bool equals(Variant const& lhs, Variant const& rhs) {
 }
 
 template <class Variant, class T>
-bool less(Variant const& lhs, Variant const& rhs) {
+std::enable_if_t<!std::is_null_pointer<T>::value, bool> less(Variant const& lhs,
+                                                             Variant const& rhs) {
   return lhs.template raw<T>() < rhs.template raw<T>();
 }
+
+// Null values are all equal, and ordered comparison of std::nullptr_t is ill-formed
+template <class Variant, class T>
+std::enable_if_t<std::is_null_pointer<T>::value, bool> less(Variant const&, Variant const&) {
+  return false;
+}
+
+// Appliers used with dispatch
+struct equals_applier {
+  template <class T, class Variant>
+  static bool apply(Variant const& lhs, Variant const& rhs) {
+    return equals<Variant, T>(lhs, rhs);
+  }
+};
+
+struct less_applier {
+  template <class T, class Variant>
+  static bool apply(Variant const& lhs, Variant const& rhs) {
+    return less<Variant, T>(lhs, rhs);
+  }
+};
 };
 
 template <class... Value>
 bool operator==(variant<Value...> const& lhs, variant<Value...> const& rhs) {
   if (lhs.type_index() == rhs.type_index()) {
-    static std::array<bool (*)(variant<Value...> const&, variant<Value...> const&),
-                      sizeof...(Value)> appliers = {helpers::equals<variant<Value...>, Value>...};
-    return appliers[lhs.type_index()](lhs, rhs);
+    return helpers::dispatch<bool, helpers::equals_applier>(lhs, lhs, rhs);
   }
   return false;
 }
@@ -936,32 +2167,207 @@ inline std::enable_if_t<!std::is_base_of<variant<Value...>, T>::value, bool> ope
 template <class... Value>
 bool operator<(variant<Value...> const& lhs, variant<Value...> const& rhs) {
   if (lhs.type_index() == rhs.type_index()) {
-    static std::array<bool (*)(variant<Value...> const&, variant<Value...> const&),
-                      sizeof...(Value)> appliers = {helpers::less<variant<Value...>, Value>...};
-    return appliers[lhs.type_index()](lhs, rhs);
+    return helpers::dispatch<bool, helpers::less_applier>(lhs, lhs, rhs);
   }
   return lhs.type_index() < rhs.type_index();
 }
 
-// template <template <class> class Object, template <class> class Array, class Key, class... Value>
-// inline bool operator==(container<Object, Array, Key, Value...> const& lhs,
-// container<Object, Array, Key, Value...> const& rhs) {
-// using variant_type = typename container<Object, Array, Key, Value...>::variant_type;
-// return static_cast<variant_type const &>(lhs) == static_cast<variant_type const &>(rhs);
-//}
-//
-// template <template <class> class Object, template <class> class Array, class Key, class... Value>
-// inline bool operator!=(container<Object, Array, Key, Value...> const& lhs,
-// container<Object, Array, Key, Value...> const& rhs) {
-// return !(lhs == rhs);
-//}
-//
-// template <template <class> class Object, template <class> class Array, class Key, class... Value>
-// inline bool operator<(container<Object, Array, Key, Value...> const& lhs,
-// container<Object, Array, Key, Value...> const& rhs) {
-// using variant_type = typename container<Object, Array, Key, Value...>::variant_type;
-// return static_cast<variant_type const &>(lhs) < static_cast<variant_type const &>(rhs);
-//}
+namespace helpers {
+//
+// Deep comparisons of containers walk both trees with an explicit stack
+//
+// Nested arrays and objects push a frame rather than recursing, so that
+// deeply nested containers do not overflow the call stack. Identical nodes,
+// including collections shared by copy on write, are skipped, and collections
+// of different sizes are never walked for equality.
+//
+template <class Container>
+class container_comparison {
+  using array_type = typename Container::array_type;
+  using object_type = typename Container::object_type;
+  using object_iterator = typename object_type::const_iterator;
+
+  struct frame {
+    array_type const* lhs_array;
+    array_type const* rhs_array;
+    std::size_t index;
+    object_type const* rhs_object;
+    object_iterator lhs_it, lhs_end, rhs_it, rhs_end;
+  };
+
+  // Outcome of the comparison of two nodes, pushed if it is decided by their children
+  enum : int { before = -1, same = 0, after = 1, pushed = 2 };
+
+  std::vector<frame> stack_;
+
+  template <class Object, class Enabler = void>
+  struct is_ordered : std::false_type {};
+  template <class Object>
+  struct is_ordered<Object, std::conditional_t<true, void, typename Object::key_compare>>
+      : std::true_type {};
+
+  static int compare_scalars(Container const& lhs, Container const& rhs, std::true_type) {
+    if (dispatch<bool, less_applier>(lhs, lhs, rhs)) return before;
+    return dispatch<bool, less_applier>(lhs, rhs, lhs) ? after : same;
+  }
+
+  // Only equality is computed, values are never ordered
+  static int compare_scalars(Container const& lhs, Container const& rhs, std::false_type) {
+    return dispatch<bool, equals_applier>(lhs, lhs, rhs) ? same : before;
+  }
+
+  static int compare_sizes(std::size_t lhs, std::size_t rhs) {
+    return lhs < rhs ? before : rhs < lhs ? after : same;
+  }
+
+  template <class Key>
+  static int compare_keys(object_type const& object, Key const& lhs, Key const& rhs) {
+    auto compare = object.key_comp();
+    return compare(lhs, rhs) ? before : compare(rhs, lhs) ? after : same;
+  }
+
+  // Compares two nodes, Ordered tells if ordering matters or only equality
+  template <bool Ordered>
+  int visit(Container const& lhs, Container const& rhs) {
+    if (&lhs == &rhs) return same;
+    if (lhs.type_index() != rhs.type_index()) {
+      if (!Ordered) return before;
+      return lhs.type_index() < rhs.type_index() ? before : after;
+    }
+    if (lhs.template is<array_type>()) {
+      array_type const& lhs_array = lhs.template get<array_type>();
+      array_type const& rhs_array = rhs.template get<array_type>();
+      if (&lhs_array == &rhs_array) return same;
+      if (!Ordered && lhs_array.size() != rhs_array.size()) return before;
+      stack_.push_back(frame{&lhs_array, &rhs_array, 0u, nullptr, {}, {}, {}, {}});
+      return pushed;
+    }
+    if (lhs.template is<object_type>()) {
+      object_type const& lhs_object = lhs.template get<object_type>();
+      object_type const& rhs_object = rhs.template get<object_type>();
+      if (&lhs_object == &rhs_object) return same;
+      if (!Ordered && lhs_object.size() != rhs_object.size()) return before;
+      stack_.push_back(frame{nullptr, nullptr, 0u, &rhs_object, lhs_object.begin(),
+                             lhs_object.end(), rhs_object.begin(), rhs_object.end()});
+      return pushed;
+    }
+    return compare_scalars(lhs, rhs, std::integral_constant<bool, Ordered>{});
+  }
+
+  // Compares the next elements of an object, in order if it is ordered
+  template <bool Ordered>
+  int visit_object(frame& top, std::true_type) {
+    if (top.lhs_it == top.lhs_end || top.rhs_it == top.rhs_end) {
+      bool const lhs_done = top.lhs_it == top.lhs_end, rhs_done = top.rhs_it == top.rhs_end;
+      stack_.pop_back();
+      return lhs_done == rhs_done ? same : lhs_done ? before : after;
+    }
+    auto lhs_it = top.lhs_it++;
+    auto rhs_it = top.rhs_it++;
+    int result = compare_keys(*top.rhs_object, lhs_it->first, rhs_it->first);
+    if (result != same) return result;
+    return visit<Ordered>(lhs_it->second, rhs_it->second);
+  }
+
+  // Compares the next element of an unordered object with the element of the same key
+  template <bool Ordered>
+  int visit_object(frame& top, std::false_type) {
+    static_assert(!Ordered, "Ordering containers requires an ordered object type");
+    if (top.lhs_it == top.lhs_end) {
+      stack_.pop_back();
+      return same;
+    }
+    auto lhs_it = top.lhs_it++;
+    auto rhs_it = top.rhs_object->find(lhs_it->first);
+    if (rhs_it == top.rhs_end) return before;
+    return visit<Ordered>(lhs_it->second, rhs_it->second);
+  }
+
+  template <bool Ordered>
+  int walk(Container const& lhs, Container const& rhs) {
+    stack_.clear();
+    int result = visit<Ordered>(lhs, rhs);
+    while (result == same || result == pushed) {
+      if (stack_.empty()) return same;
+      frame& top = stack_.back();
+      if (top.lhs_array) {
+        if (top.index == top.lhs_array->size() || top.index == top.rhs_array->size()) {
+          result = compare_sizes(top.lhs_array->size(), top.rhs_array->size());
+          stack_.pop_back();
+        } else {
+          std::size_t const index = top.index++;
+          result = visit<Ordered>((*top.lhs_array)[index], (*top.rhs_array)[index]);
+        }
+      } else {
+        result = visit_object<Ordered>(top, is_ordered<object_type>{});
+      }
+    }
+    return result;
+  }
+
+ public:
+  bool equal_to(Container const& lhs, Container const& rhs) { return same == walk<false>(lhs, rhs); }
+
+  int compare(Container const& lhs, Container const& rhs) { return walk<true>(lhs, rhs); }
+};
+}  // namespace helpers
+
+//
+// Three way comparison of containers, returns a negative, null or positive value
+//
+// Values of different types are ordered by type index, arrays and objects
+// lexicographically. Objects shall be ordered associative containers.
+//
+template <template <class...> class Object, template <class...> class Array, class Key,
+          class... Value>
+int compare(container<Object, Array, Key, Value...> const& lhs,
+            container<Object, Array, Key, Value...> const& rhs) {
+  return helpers::container_comparison<container<Object, Array, Key, Value...>>{}.compare(lhs,
+                                                                                          rhs);
+}
+
+template <template <class...> class Object, template <class...> class Array, class Key,
+          class... Value>
+bool operator==(container<Object, Array, Key, Value...> const& lhs,
+                container<Object, Array, Key, Value...> const& rhs) {
+  return helpers::container_comparison<container<Object, Array, Key, Value...>>{}.equal_to(lhs,
+                                                                                           rhs);
+}
+
+template <template <class...> class Object, template <class...> class Array, class Key,
+          class... Value>
+inline bool operator!=(container<Object, Array, Key, Value...> const& lhs,
+                       container<Object, Array, Key, Value...> const& rhs) {
+  return !(lhs == rhs);
+}
+
+template <template <class...> class Object, template <class...> class Array, class Key,
+          class... Value>
+inline bool operator<(container<Object, Array, Key, Value...> const& lhs,
+                      container<Object, Array, Key, Value...> const& rhs) {
+  return compare(lhs, rhs) < 0;
+}
+
+template <template <class...> class Object, template <class...> class Array, class Key,
+          class... Value>
+inline bool operator>(container<Object, Array, Key, Value...> const& lhs,
+                      container<Object, Array, Key, Value...> const& rhs) {
+  return compare(lhs, rhs) > 0;
+}
+
+template <template <class...> class Object, template <class...> class Array, class Key,
+          class... Value>
+inline bool operator<=(container<Object, Array, Key, Value...> const& lhs,
+                       container<Object, Array, Key, Value...> const& rhs) {
+  return compare(lhs, rhs) <= 0;
+}
+
+template <template <class...> class Object, template <class...> class Array, class Key,
+          class... Value>
+inline bool operator>=(container<Object, Array, Key, Value...> const& lhs,
+                       container<Object, Array, Key, Value...> const& rhs) {
+  return compare(lhs, rhs) >= 0;
+}
 
 // element_init is used to write elegant jsonlike notations
 template <class Container>
@@ -973,8 +2379,9 @@ class element_init {
   using container_type = Container;
   element_init(typename Container::object_type::key_type const& key) : key_{key} {}
   element_init(typename Container::object_type::key_type&& key) : key_{std::move(key)} {}
+  // Returns the pair expected by make_object, whatever the value_type of the object
   template <class T>
-  typename Container::object_type::value_type operator=(T&& value) && {
+  std::pair<typename Container::object_type::key_type const, Container> operator=(T&& value) && {
     return {std::move(key_), std::forward<T>(value)};
   }
 };
@@ -990,6 +2397,14 @@ Container make_object(std::initializer_list<std::pair<Key const, Container>> ele
   return elements;
 }
 
+// Make an object out of an initializer list, allocated on the given resource
+template <class Container, class Key = typename Container::key_type>
+Container make_object(memory_resource& resource,
+                      std::initializer_list<std::pair<Key const, Container>> elements) {
+  default_resource_guard guard{resource};
+  return elements;
+}
+
 //
 // Make an array out of an initializer list
 //
@@ -1001,22 +2416,164 @@ Container make_array(std::initializer_list<Container> elements) {
   return elements;
 }
 
+// Make an array out of an initializer list, allocated on the given resource
+template <class Container>
+Container make_array(memory_resource& resource, std::initializer_list<Container> elements) {
+  default_resource_guard guard{resource};
+  return elements;
+}
+
+namespace helpers {
+template <class Collection>
+auto reserve(Collection& collection, std::size_t size, int)
+    -> decltype(collection.reserve(size), void()) {
+  collection.reserve(size);
+}
+
+// Collections without reserve, such as std::map, are left as is
+template <class Collection>
+void reserve(Collection&, std::size_t, long) {}
+}  // namespace helpers
+
+//
+// object_builder builds an object by moving its elements in place
+//
+// Unlike make_object with an initializer list, whose elements are const and
+// thus copied, values are moved so that each nested container is allocated
+// once. As with initializer lists, the first of duplicated keys is kept.
+//
+template <class Container>
+class object_builder {
+ public:
+  using container_type = Container;
+  using key_type = typename Container::key_type;
+  using object_type = typename Container::object_type;
+
+ private:
+  object_type object_;
+
+ public:
+  object_builder() = default;
+  explicit object_builder(std::size_t size) { reserve(size); }
+
+  // Reserves room for size elements if the object type supports it
+  object_builder& reserve(std::size_t size) {
+    helpers::reserve(object_, size, 0);
+    return *this;
+  }
+
+  // Constructs the value at key from the arguments
+  template <class K, class... Args>
+  object_builder& emplace(K&& key, Args&&... args) {
+    object_.emplace(std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)),
+                    std::forward_as_tuple(std::forward<Args>(args)...));
+    return *this;
+  }
+
+  template <class K, class T>
+  object_builder& add(K&& key, T&& value) {
+    return emplace(std::forward<K>(key), std::forward<T>(value));
+  }
+
+  std::size_t size() const noexcept { return object_.size(); }
+
+  // Returns the built container, leaving the builder empty
+  Container build() { return Container{std::move(object_)}; }
+};
+
+//
+// array_builder builds an array by moving its elements in place
+//
+template <class Container>
+class array_builder {
+ public:
+  using container_type = Container;
+  using array_type = typename Container::array_type;
+
+ private:
+  array_type array_;
+
+ public:
+  array_builder() = default;
+  explicit array_builder(std::size_t size) { reserve(size); }
+
+  // Reserves room for size elements if the array type supports it
+  array_builder& reserve(std::size_t size) {
+    helpers::reserve(array_, size, 0);
+    return *this;
+  }
+
+  // Constructs an element at the end of the array from the arguments
+  template <class... Args>
+  array_builder& emplace_back(Args&&... args) {
+    array_.emplace_back(std::forward<Args>(args)...);
+    return *this;
+  }
+
+  template <class T>
+  array_builder& add(T&& value) {
+    return emplace_back(std::forward<T>(value));
+  }
+
+  std::size_t size() const noexcept { return array_.size(); }
+
+  // Returns the built container, leaving the builder empty
+  Container build() { return Container{std::move(array_)}; }
+};
+
+//
+// Make an object out of key value pairs, moving the values
+//
+// Pairs are those returned by element_init, so that literals read as with
+// initializer lists, without braces:
+//
+// auto c = make_object("name"_a = "Roger", "children"_a = make_array(...));
+//
+template <class Container, class Key, class... Others>
+Container make_object(std::pair<Key const, Container>&& first, Others&&... others) {
+  object_builder<Container> builder{1u + sizeof...(Others)};
+  builder.add(first.first, std::move(first.second));
+  int expander[] = {0, (builder.add(others.first, std::forward<Others>(others).second), 0)...};
+  (void)expander;
+  return builder.build();
+}
+
+//
+// Make an array out of containers, moving them
+//
+template <class First, class... Others, class Container = std::decay_t<First>,
+          class Enabler =
+              std::pair<typename Container::variant_type, typename Container::array_type>>
+Container make_array(First&& first, Others&&... others) {
+  array_builder<Container> builder{1u + sizeof...(Others)};
+  builder.add(std::forward<First>(first));
+  int expander[] = {0, (builder.add(std::forward<Others>(others)), 0)...};
+  (void)expander;
+  return builder.build();
+}
+
 namespace visiting_helpers {
 // applier_maker generates function pointers
 template <class Return, class... Value>
 struct applier_maker;
 template <class Return, class... Value>
 struct applier_maker<Return, variant<Value...>> {
-  template <class Visitor, class T, class... ExtraArguments>
-  static Return applier_fp(variant<Value...>& values, Visitor visitor, ExtraArguments... extras) {
-    return visitor(values.template raw<T>(), std::forward<ExtraArguments>(extras)...);
-  }
+  template <class Visitor, class... ExtraArguments>
+  struct applier {
+    template <class T>
+    static Return apply(variant<Value...>& values, Visitor visitor, ExtraArguments... extras) {
+      return visitor(values.template raw<T>(), std::forward<ExtraArguments>(extras)...);
+    }
+  };
 
-  template <class Visitor, class T, class... ExtraArguments>
-  static Return const_applier_fp(variant<Value...> const& values, Visitor visitor,
-                                 ExtraArguments... extras) {
-    return visitor(values.template raw<T>(), std::forward<ExtraArguments>(extras)...);
-  }
+  template <class Visitor, class... ExtraArguments>
+  struct const_applier {
+    template <class T>
+    static Return apply(variant<Value...> const& values, Visitor visitor,
+                        ExtraArguments... extras) {
+      return visitor(values.template raw<T>(), std::forward<ExtraArguments>(extras)...);
+    }
+  };
 };
 // Extend to container
 template <class Return, template <class...> class Object, template <class...> class Array,
@@ -1030,27 +2587,117 @@ struct applier_maker<Return, container<Object, Array, Key, Value...>>
 
 template <class Return, class Visitor, class... Value, class... ExtraArguments>
 Return apply_visitor(variant<Value...>& values, Visitor&& visitor, ExtraArguments&&... extras) {
-  static std::array<Return (*)(variant<Value...>&, std::add_lvalue_reference_t<Visitor>,
-                               ExtraArguments...),
-                    sizeof...(Value)> appliers = {
-      visiting_helpers::applier_maker<Return, variant<Value...>>::template applier_fp<
-          std::add_lvalue_reference_t<Visitor>, Value, ExtraArguments...>...};
-  return appliers[values.type_index()](values, std::forward<Visitor>(visitor),
-                                       std::forward<ExtraArguments>(extras)...);
+  using applier = typename visiting_helpers::applier_maker<Return, variant<Value...>>::
+      template applier<std::add_lvalue_reference_t<Visitor>, ExtraArguments...>;
+  return helpers::dispatch<Return, applier>(values, values, visitor,
+                                            std::forward<ExtraArguments>(extras)...);
 };
 
 template <class Return, class Visitor, class... Value, class... ExtraArguments>
 Return apply_visitor(variant<Value...> const& values, Visitor&& visitor,
                      ExtraArguments&&... extras) {
-  static std::array<Return (*)(variant<Value...> const&, std::add_lvalue_reference_t<Visitor>,
-                               ExtraArguments...),
-                    sizeof...(Value)> appliers = {
-      visiting_helpers::applier_maker<Return, variant<Value...>>::template const_applier_fp<
-          std::add_lvalue_reference_t<Visitor>, Value, ExtraArguments...>...};
-  return appliers[values.type_index()](values, std::forward<Visitor>(visitor),
-                                       std::forward<ExtraArguments>(extras)...);
+  using applier = typename visiting_helpers::applier_maker<Return, variant<Value...>>::
+      template const_applier<std::add_lvalue_reference_t<Visitor>, ExtraArguments...>;
+  return helpers::dispatch<Return, applier>(values, values, visitor,
+                                            std::forward<ExtraArguments>(extras)...);
 };
 
+namespace visiting_helpers {
+// is_variant detects variants and types deriving from them, such as containers
+template <class... Value>
+std::true_type is_variant_impl(variant<Value...> const*);
+std::false_type is_variant_impl(...);
+
+template <class T>
+using is_variant = decltype(is_variant_impl(std::declval<std::decay_t<T>*>()));
+
+template <class... Variants>
+using enable_if_variants_t = std::enable_if_t<
+    arithmetics::all_equals<bool, sizeof...(Variants)>({is_variant<Variants>::value...}, true),
+    void>;
+
+//
+// flat_indices maps a flat index to the indices of several variants
+//
+// The index of the last variant varies the fastest, as in a row major array.
+// type_at<Flat>::type is the std::index_sequence of the matching indices.
+//
+template <std::size_t... Sizes>
+struct flat_indices {
+  static constexpr std::size_t size = arithmetics::product<std::size_t, sizeof...(Sizes)>({Sizes...});
+
+  static constexpr std::size_t size_at(std::size_t position) {
+    std::size_t const sizes[] = {Sizes...};
+    return sizes[position];
+  }
+
+  static constexpr std::size_t stride(std::size_t position) {
+    std::size_t const sizes[] = {Sizes...};
+    std::size_t result = 1u;
+    for (std::size_t next = position + 1u; next < sizeof...(Sizes); ++next) result *= sizes[next];
+    return result;
+  }
+
+  template <std::size_t Flat, class Positions = std::make_index_sequence<sizeof...(Sizes)>>
+  struct type_at;
+
+  template <std::size_t Flat, std::size_t... Positions>
+  struct type_at<Flat, std::index_sequence<Positions...>> {
+    using type = std::index_sequence<(Flat / stride(Positions)) % size_at(Positions)...>;
+  };
+
+  static std::size_t flatten(std::array<std::size_t, sizeof...(Sizes)> const& indices) {
+    std::size_t result = 0u;
+    for (std::size_t position = 0u; position < sizeof...(Sizes); ++position)
+      result = result * size_at(position) + indices[position];
+    return result;
+  }
+};
+
+// multi_applier calls a visitor on the values held by several variants
+template <class Return, class Visitor, class... Variants>
+struct multi_applier {
+  template <std::size_t... Indices>
+  static Return call(std::index_sequence<Indices...>, Visitor visitor, Variants&... values) {
+    return visitor(values.template raw<typename std::decay_t<Variants>::type_list_t::template type_at<
+                       Indices>::type>()...);
+  }
+
+  template <class Indices>
+  static Return apply(Visitor visitor, Variants&... values) {
+    return call(Indices{}, visitor, values...);
+  }
+};
+}  // namespace visiting_helpers
+
+//
+// Visits several variants at once
+//
+// The visitor is called with the values held by every variant. Combinations of
+// types are flattened in a single index so that dispatch happens only once,
+// through a switch for few combinations and a table of functions otherwise.
+// The visitor comes first to tell this overload from extra arguments.
+//
+template <class Return, class Visitor, class First, class Second, class... Others,
+          class Enabler = visiting_helpers::enable_if_variants_t<First, Second, Others...>>
+Return apply_visitor(Visitor&& visitor, First&& first, Second&& second, Others&&... others) {
+  using indices = visiting_helpers::flat_indices<std::decay_t<First>::type_list_t::size,
+                                                 std::decay_t<Second>::type_list_t::size,
+                                                 std::decay_t<Others>::type_list_t::size...>;
+  using applier =
+      visiting_helpers::multi_applier<Return, std::add_lvalue_reference_t<Visitor>,
+                                      std::remove_reference_t<First>,
+                                      std::remove_reference_t<Second>,
+                                      std::remove_reference_t<Others>...>;
+  using switch_dispatch_t = helpers::switch_dispatch<Return, indices, indices::size>;
+  using dispatcher =
+      std::conditional_t<(indices::size <= switch_dispatch_t::chunk_size), switch_dispatch_t,
+                         helpers::table_dispatch<Return, indices>>;
+  std::size_t const flat =
+      indices::flatten({{first.type_index(), second.type_index(), others.type_index()...}});
+  return dispatcher::template apply<applier>(flat, visitor, first, second, others...);
+}
+
 //
 // Visitor generated with functions
 //
@@ -1282,6 +2929,9 @@ class view {
 
   bool empty() const& noexcept { return nullptr == container_; }
 
+  // Returns the viewed container, nullptr if the view is empty
+  Container const* get_container() const& noexcept { return container_; }
+
   view operator[](size_t value) const & {
     if (container_ && container_->template is<typename Container::array_type>()) {
       return view{container_->template get<typename Container::array_type>()[value]};
@@ -1292,8 +2942,8 @@ class view {
   template <class T, class Enabler = std::enable_if_t<!std::is_integral<std::decay_t<T>>(), void>>
   view operator[](T&& value) const & {
     if (container_ && container_->template is<typename Container::object_type>()) {
-      auto value_it =
-          container_->template get<typename Container::object_type>().find(std::forward<T>(value));
+      auto value_it = container_->template get<typename Container::object_type>().find(
+          helpers::lookup_key<typename Container::object_type>(std::forward<T>(value)));
       if (value_it != container_->template get<typename Container::object_type>().end()) {
         return view{value_it->second};
       }
@@ -0,0 +1,174 @@
+#ifndef JSON_BACKBONE_ARENA_HEADER
+#define JSON_BACKBONE_ARENA_HEADER
+#include <json_backbone/pmr.hpp>
+#include <cstdint>
+#include <type_traits>
+
+namespace json_backbone {
+//
+// monotonic_resource bump allocates from chunks obtained from an upstream resource
+//
+// Deallocation is a no-op, memory is only given back by release or destruction.
+// Chunks grow geometrically, release keeps the last and largest one for reuse.
+//
+class monotonic_resource final : public memory_resource {
+  struct chunk {
+    chunk* next;
+    std::size_t size;
+  };
+
+  memory_resource* upstream_;
+  std::size_t next_size_;
+  chunk* chunks_ = nullptr;
+  unsigned char* current_ = nullptr;
+  unsigned char* end_ = nullptr;
+
+  static constexpr std::size_t header_size =
+      (sizeof(chunk) + alignof(std::max_align_t) - 1u) & ~(alignof(std::max_align_t) - 1u);
+
+  void add_chunk(std::size_t bytes, std::size_t alignment) {
+    std::size_t size = header_size + bytes + alignment;
+    if (size < next_size_) size = next_size_;
+    chunk* added = static_cast<chunk*>(upstream_->allocate(size, alignof(std::max_align_t)));
+    added->next = chunks_;
+    added->size = size;
+    chunks_ = added;
+    current_ = reinterpret_cast<unsigned char*>(added) + header_size;
+    end_ = reinterpret_cast<unsigned char*>(added) + size;
+    next_size_ = size + size / 2u;
+  }
+
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    std::uintptr_t address = reinterpret_cast<std::uintptr_t>(current_);
+    std::size_t padding = (alignment - address % alignment) % alignment;
+    if (!current_ || static_cast<std::size_t>(end_ - current_) < padding + bytes) {
+      add_chunk(bytes, alignment);
+      address = reinterpret_cast<std::uintptr_t>(current_);
+      padding = (alignment - address % alignment) % alignment;
+    }
+    void* result = current_ + padding;
+    current_ += padding + bytes;
+    return result;
+  }
+
+  void do_deallocate(void*, std::size_t, std::size_t) override {}
+
+  bool do_is_equal(memory_resource const& other) const noexcept override {
+    return this == &other;
+  }
+
+ public:
+  explicit monotonic_resource(std::size_t initial_size = 4096u,
+                              memory_resource* upstream = get_default_resource())
+      : upstream_{upstream}, next_size_{initial_size} {}
+  monotonic_resource(monotonic_resource const&) = delete;
+  monotonic_resource& operator=(monotonic_resource const&) = delete;
+  ~monotonic_resource() {
+    release();
+    if (chunks_) upstream_->deallocate(chunks_, chunks_->size, alignof(std::max_align_t));
+  }
+
+  // Gives back every chunk but the last one, whose memory is reused
+  void release() noexcept {
+    if (!chunks_) return;
+    chunk* kept = chunks_;
+    for (chunk* current = kept->next; current;) {
+      chunk* next = current->next;
+      upstream_->deallocate(current, current->size, alignof(std::max_align_t));
+      current = next;
+    }
+    kept->next = nullptr;
+    chunks_ = kept;
+    current_ = reinterpret_cast<unsigned char*>(kept) + header_size;
+    end_ = reinterpret_cast<unsigned char*>(kept) + kept->size;
+  }
+
+  memory_resource* upstream_resource() const noexcept { return upstream_; }
+};
+
+//
+// is_trivially_releasable tells if destroying a type only gives memory back to its allocator
+//
+// Such types may be dropped without running their destructor when their memory
+// comes from a monotonic_resource. Specialize it for your own types.
+//
+template <class T>
+struct is_trivially_releasable : std::is_trivially_destructible<T> {};
+
+namespace helpers {
+template <class T>
+struct is_polymorphic_allocator : std::false_type {};
+
+template <class T>
+struct is_polymorphic_allocator<polymorphic_allocator<T>> : std::true_type {};
+
+template <bool... Values>
+struct all_of : std::is_same<all_of<Values...>, all_of<(Values, true)...>> {};
+}
+
+template <class Char, class Traits, class Allocator>
+struct is_trivially_releasable<std::basic_string<Char, Traits, Allocator>>
+    : helpers::is_polymorphic_allocator<Allocator> {};
+
+template <template <class...> class ObjectBase, template <class...> class ArrayBase, class Key,
+          class... Value>
+struct is_trivially_releasable<container<ObjectBase, ArrayBase, Key, Value...>>
+    : std::integral_constant<
+          bool,
+          helpers::is_polymorphic_allocator<typename container<
+              ObjectBase, ArrayBase, Key, Value...>::traits_type::allocator_type>::value &&
+              helpers::is_polymorphic_allocator<typename container<
+                  ObjectBase, ArrayBase, Key, Value...>::object_type::allocator_type>::value &&
+              helpers::is_polymorphic_allocator<typename container<
+                  ObjectBase, ArrayBase, Key, Value...>::array_type::allocator_type>::value &&
+              is_trivially_releasable<Key>::value &&
+              helpers::all_of<is_trivially_releasable<Value>::value...>::value> {};
+
+//
+// arena_document owns a container whose whole tree is allocated in one arena
+//
+// Every node, heap value, string and collection buffer created while the
+// guard returned by scope is alive comes from the arena. Teardown is then a
+// single arena release which skips every per node destructor when the
+// container is trivially releasable. Values created outside of scope, or
+// copied in from another resource, must not be stored in the document.
+//
+template <class Container>
+class arena_document {
+  monotonic_resource resource_;
+  std::aligned_storage_t<sizeof(Container), alignof(Container)> root_;
+
+  void destroy_root() noexcept {
+    if (!is_trivially_releasable<Container>::value) root().~Container();
+  }
+
+ public:
+  using container_type = Container;
+
+  explicit arena_document(std::size_t initial_size = 4096u,
+                          memory_resource* upstream = get_default_resource())
+      : resource_{initial_size, upstream} {
+    new (&root_) Container();
+  }
+  arena_document(arena_document const&) = delete;
+  arena_document& operator=(arena_document const&) = delete;
+  ~arena_document() { destroy_root(); }
+
+  // Makes the arena the default resource of the calling thread for the guard lifetime
+  default_resource_guard scope() noexcept { return default_resource_guard{resource_}; }
+
+  Container& root() noexcept { return *reinterpret_cast<Container*>(&root_); }
+  Container const& root() const noexcept { return *reinterpret_cast<Container const*>(&root_); }
+
+  // Drops the whole tree and reuses the arena
+  void reset() noexcept {
+    destroy_root();
+    resource_.release();
+    new (&root_) Container();
+  }
+
+  monotonic_resource& resource() noexcept { return resource_; }
+};
+}  // namespace json_backbone
+
+#endif  // JSON_BACKBONE_ARENA_HEADER
@@ -0,0 +1,216 @@
+#ifndef JSON_BACKBONE_COMPACT_STRING_HEADER
+#define JSON_BACKBONE_COMPACT_STRING_HEADER
+#include <json_backbone/transparent.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#if 201703L <= __cplusplus
+#include <string_view>
+#endif
+
+namespace json_backbone {
+//
+// basic_compact_string is an immutable string of Size bytes for variant alternatives
+//
+// Up to Size - 1 characters are stored inline, so that a compact_string of the
+// width of a pointer is a small type held in the variant buffer itself. Longer
+// strings spill to a single heap block holding their size and characters.
+//
+// The first byte tells the representations apart: inline strings store their
+// size shifted left and tagged with the low bit, heap strings store the low
+// byte of their block address, which is even. Inline characters are not null
+// terminated, use data and size or convert to std::string.
+//
+template <std::size_t Size>
+class basic_compact_string {
+  static_assert(sizeof(std::uintptr_t) <= Size && Size <= 128u,
+                "compact strings hold a pointer and at most 127 inline characters");
+
+  alignas(std::uintptr_t) unsigned char bytes_[Size];
+
+  static constexpr std::size_t header_size = sizeof(std::size_t);
+
+  bool is_inline() const noexcept { return bytes_[0] & 1u; }
+
+  // Pointers are stored low byte first whatever the byte order
+  char* block() const noexcept {
+    std::uintptr_t word = 0u;
+    for (std::size_t index = 0; index < sizeof(word); ++index)
+      word |= static_cast<std::uintptr_t>(bytes_[index]) << (8u * index);
+    return reinterpret_cast<char*>(word);
+  }
+
+  void set_block(char* block) noexcept {
+    std::uintptr_t word = reinterpret_cast<std::uintptr_t>(block);
+    for (std::size_t index = 0; index < sizeof(word); ++index)
+      bytes_[index] = static_cast<unsigned char>(word >> (8u * index));
+  }
+
+  void set_inline(char const* text, std::size_t size) noexcept {
+    bytes_[0] = static_cast<unsigned char>((size << 1u) | 1u);
+    if (size) std::memcpy(bytes_ + 1, text, size);
+  }
+
+  void assign(char const* text, std::size_t size) {
+    if (size < Size) {
+      set_inline(text, size);
+      return;
+    }
+    char* block = static_cast<char*>(::operator new(header_size + size + 1u));
+    std::memcpy(block, &size, header_size);
+    std::memcpy(block + header_size, text, size);
+    block[header_size + size] = '\0';
+    set_block(block);
+  }
+
+ public:
+  using value_type = char;
+  using size_type = std::size_t;
+  using const_iterator = char const*;
+  using iterator = const_iterator;
+
+  // Number of characters stored without allocation
+  static constexpr std::size_t inline_capacity = Size - 1u;
+
+  basic_compact_string() noexcept { set_inline(nullptr, 0u); }
+  basic_compact_string(char const* text, std::size_t size) { assign(text, size); }
+  // Null pointers are rejected as by std::string, nullptr itself does not convert
+  basic_compact_string(char const* text) {
+    if (!text) throw std::logic_error("basic_compact_string: construction from null is not valid");
+    assign(text, std::strlen(text));
+  }
+  basic_compact_string(std::nullptr_t) = delete;
+  basic_compact_string(std::string const& text) { assign(text.data(), text.size()); }
+#if 201703L <= __cplusplus
+  basic_compact_string(std::string_view text) { assign(text.data(), text.size()); }
+#endif
+
+  basic_compact_string(basic_compact_string const& other) {
+    if (other.is_inline())
+      std::memcpy(bytes_, other.bytes_, Size);
+    else
+      assign(other.data(), other.size());
+  }
+
+  basic_compact_string(basic_compact_string&& other) noexcept {
+    std::memcpy(bytes_, other.bytes_, Size);
+    other.set_inline(nullptr, 0u);
+  }
+
+  basic_compact_string& operator=(basic_compact_string other) noexcept {
+    swap(other);
+    return *this;
+  }
+
+  ~basic_compact_string() {
+    if (!is_inline()) ::operator delete(block());
+  }
+
+  void swap(basic_compact_string& other) noexcept { std::swap(bytes_, other.bytes_); }
+
+  char const* data() const noexcept {
+    return is_inline() ? reinterpret_cast<char const*>(bytes_ + 1) : block() + header_size;
+  }
+
+  std::size_t size() const noexcept {
+    if (is_inline()) return bytes_[0] >> 1u;
+    std::size_t size;
+    std::memcpy(&size, block(), header_size);
+    return size;
+  }
+
+  bool empty() const noexcept { return 0u == size(); }
+
+  const_iterator begin() const noexcept { return data(); }
+  const_iterator end() const noexcept { return data() + size(); }
+
+  // Tells if the characters are stored in the string itself
+  bool stored_inline() const noexcept { return is_inline(); }
+
+  std::string str() const { return {data(), size()}; }
+  operator std::string() const { return str(); }
+#if 201703L <= __cplusplus
+  operator std::string_view() const noexcept { return {data(), size()}; }
+#endif
+
+  // Three way comparison with a sequence of characters
+  int compare(char const* text, std::size_t size) const noexcept {
+    std::size_t const own_size = this->size();
+    int result = std::memcmp(data(), text, std::min(own_size, size));
+    if (result) return result;
+    return own_size < size ? -1 : size < own_size ? 1 : 0;
+  }
+
+  int compare(basic_compact_string const& other) const noexcept {
+    return compare(other.data(), other.size());
+  }
+
+  friend bool operator==(basic_compact_string const& lhs, basic_compact_string const& rhs) noexcept {
+    return 0 == lhs.compare(rhs);
+  }
+  friend bool operator!=(basic_compact_string const& lhs, basic_compact_string const& rhs) noexcept {
+    return 0 != lhs.compare(rhs);
+  }
+  friend bool operator<(basic_compact_string const& lhs, basic_compact_string const& rhs) noexcept {
+    return lhs.compare(rhs) < 0;
+  }
+
+  friend bool operator==(basic_compact_string const& lhs, std::string const& rhs) noexcept {
+    return 0 == lhs.compare(rhs.data(), rhs.size());
+  }
+  friend bool operator==(std::string const& lhs, basic_compact_string const& rhs) noexcept {
+    return rhs == lhs;
+  }
+  friend bool operator!=(basic_compact_string const& lhs, std::string const& rhs) noexcept {
+    return !(lhs == rhs);
+  }
+  friend bool operator!=(std::string const& lhs, basic_compact_string const& rhs) noexcept {
+    return !(rhs == lhs);
+  }
+
+  friend bool operator==(basic_compact_string const& lhs, char const* rhs) noexcept {
+    return 0 == lhs.compare(rhs, std::strlen(rhs));
+  }
+  friend bool operator==(char const* lhs, basic_compact_string const& rhs) noexcept {
+    return rhs == lhs;
+  }
+  friend bool operator!=(basic_compact_string const& lhs, char const* rhs) noexcept {
+    return !(lhs == rhs);
+  }
+  friend bool operator!=(char const* lhs, basic_compact_string const& rhs) noexcept {
+    return !(rhs == lhs);
+  }
+
+  friend std::ostream& operator<<(std::ostream& output, basic_compact_string const& value) {
+    return output.write(value.data(), static_cast<std::streamsize>(value.size()));
+  }
+};
+
+template <std::size_t Size>
+constexpr std::size_t basic_compact_string<Size>::inline_capacity;
+
+template <std::size_t Size>
+constexpr std::size_t basic_compact_string<Size>::header_size;
+
+// Compact string as wide as a pointer, a small type with default variant traits
+using compact_string = basic_compact_string<sizeof(void*)>;
+
+// Compact string of two pointers, a small type with an inline_capacity of 16
+using compact_string16 = basic_compact_string<2u * sizeof(void*)>;
+}  // namespace json_backbone
+
+namespace std {
+template <std::size_t Size>
+struct hash<json_backbone::basic_compact_string<Size>> {
+  std::size_t operator()(json_backbone::basic_compact_string<Size> const& value) const noexcept {
+    return json_backbone::helpers::hash_bytes(value.data(), value.size());
+  }
+};
+}  // namespace std
+
+#endif  // JSON_BACKBONE_COMPACT_STRING_HEADER
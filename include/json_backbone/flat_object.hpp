@@ -0,0 +1,222 @@
+#ifndef JSON_BACKBONE_FLAT_OBJECT_HEADER
+#define JSON_BACKBONE_FLAT_OBJECT_HEADER
+#include <json_backbone.hpp>
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace json_backbone {
+//
+// flat_object is an associative container storing its elements in a sorted vector
+//
+// Keys and values are contiguous, which makes lookup of small objects and
+// iteration much faster than with node based maps. Insertion and removal are
+// linear. It can be used as the ObjectBase of a container:
+//
+// container<flat_object, std::vector, std::string, ...>
+//
+// Unlike std::map, value_type is std::pair<Key, Value> so that elements can be
+// moved. Keys must not be modified through iterators. The default comparator is
+// transparent, keys are looked up without being converted to Key.
+//
+template <class Key, class Value, class Compare = std::less<>,
+          class Allocator = std::allocator<std::pair<Key, Value>>>
+class flat_object {
+ public:
+  using key_type = Key;
+  using mapped_type = Value;
+  using value_type = std::pair<Key, Value>;
+  using key_compare = Compare;
+  using allocator_type = Allocator;
+  using storage_type = std::vector<value_type, Allocator>;
+  using size_type = typename storage_type::size_type;
+  using difference_type = typename storage_type::difference_type;
+  using reference = value_type&;
+  using const_reference = value_type const&;
+  using iterator = typename storage_type::iterator;
+  using const_iterator = typename storage_type::const_iterator;
+  using reverse_iterator = typename storage_type::reverse_iterator;
+  using const_reverse_iterator = typename storage_type::const_reverse_iterator;
+
+ private:
+  storage_type elements_;
+  Compare compare_;
+
+  // Type keys are looked up as, converted once to Key unless Compare is transparent
+  template <class K>
+  using lookup_t = std::conditional_t<is_transparent<Compare>::value, K, Key>;
+
+  template <class K>
+  iterator lower_bound_impl(K const& key) {
+    return std::lower_bound(elements_.begin(), elements_.end(), key,
+                            [this](value_type const& element, K const& other) {
+                              return compare_(element.first, other);
+                            });
+  }
+
+  template <class K>
+  const_iterator lower_bound_impl(K const& key) const {
+    return std::lower_bound(elements_.begin(), elements_.end(), key,
+                            [this](value_type const& element, K const& other) {
+                              return compare_(element.first, other);
+                            });
+  }
+
+  template <class K>
+  bool matches(const_iterator it, K const& key) const {
+    return it != elements_.end() && !compare_(key, it->first);
+  }
+
+  // Sorts elements and removes duplicated keys, keeping the first ones
+  void normalize() {
+    std::stable_sort(
+        elements_.begin(), elements_.end(),
+        [this](value_type const& lhs, value_type const& rhs) { return compare_(lhs.first, rhs.first); });
+    elements_.erase(std::unique(elements_.begin(), elements_.end(),
+                                [this](value_type const& lhs, value_type const& rhs) {
+                                  return !compare_(lhs.first, rhs.first);
+                                }),
+                    elements_.end());
+  }
+
+ public:
+  flat_object() = default;
+
+  explicit flat_object(Allocator const& allocator) : elements_(allocator) {}
+
+  flat_object(std::initializer_list<std::pair<Key const, Value>> elements,
+              Allocator const& allocator = Allocator())
+      : elements_(elements.begin(), elements.end(), allocator) {
+    normalize();
+  }
+
+  template <class InputIterator>
+  flat_object(InputIterator first, InputIterator last, Allocator const& allocator = Allocator())
+      : elements_(first, last, allocator) {
+    normalize();
+  }
+
+  allocator_type get_allocator() const { return elements_.get_allocator(); }
+  key_compare key_comp() const { return compare_; }
+
+  iterator begin() noexcept { return elements_.begin(); }
+  const_iterator begin() const noexcept { return elements_.begin(); }
+  const_iterator cbegin() const noexcept { return elements_.cbegin(); }
+  iterator end() noexcept { return elements_.end(); }
+  const_iterator end() const noexcept { return elements_.end(); }
+  const_iterator cend() const noexcept { return elements_.cend(); }
+  reverse_iterator rbegin() noexcept { return elements_.rbegin(); }
+  const_reverse_iterator rbegin() const noexcept { return elements_.rbegin(); }
+  reverse_iterator rend() noexcept { return elements_.rend(); }
+  const_reverse_iterator rend() const noexcept { return elements_.rend(); }
+
+  bool empty() const noexcept { return elements_.empty(); }
+  size_type size() const noexcept { return elements_.size(); }
+  size_type capacity() const noexcept { return elements_.capacity(); }
+  void reserve(size_type size) { elements_.reserve(size); }
+  void shrink_to_fit() { elements_.shrink_to_fit(); }
+  void clear() noexcept { elements_.clear(); }
+
+  iterator find(Key const& key) {
+    iterator it = lower_bound_impl(key);
+    return matches(it, key) ? it : elements_.end();
+  }
+
+  const_iterator find(Key const& key) const {
+    const_iterator it = lower_bound_impl(key);
+    return matches(it, key) ? it : elements_.end();
+  }
+
+  template <class K, class C = Compare, class = typename C::is_transparent>
+  iterator find(K const& key) {
+    iterator it = lower_bound_impl(key);
+    return matches(it, key) ? it : elements_.end();
+  }
+
+  template <class K, class C = Compare, class = typename C::is_transparent>
+  const_iterator find(K const& key) const {
+    const_iterator it = lower_bound_impl(key);
+    return matches(it, key) ? it : elements_.end();
+  }
+
+  size_type count(Key const& key) const { return find(key) == end() ? 0u : 1u; }
+
+  template <class K, class C = Compare, class = typename C::is_transparent>
+  size_type count(K const& key) const {
+    return find(key) == end() ? 0u : 1u;
+  }
+
+  iterator lower_bound(Key const& key) { return lower_bound_impl(key); }
+  const_iterator lower_bound(Key const& key) const { return lower_bound_impl(key); }
+
+  Value& at(Key const& key) {
+    iterator it = find(key);
+    if (it == end()) throw std::out_of_range("flat_object::at");
+    return it->second;
+  }
+
+  Value const& at(Key const& key) const {
+    const_iterator it = find(key);
+    if (it == end()) throw std::out_of_range("flat_object::at");
+    return it->second;
+  }
+
+  Value& operator[](Key const& key) { return try_emplace(key).first->second; }
+  Value& operator[](Key&& key) { return try_emplace(std::move(key)).first->second; }
+
+  // Constructs the value in place if key does not exist yet
+  template <class K, class... Args>
+  std::pair<iterator, bool> try_emplace(K&& key, Args&&... args) {
+    lookup_t<std::decay_t<K>> const& lookup = key;
+    iterator it = lower_bound_impl(lookup);
+    if (matches(it, lookup)) return {it, false};
+    it = elements_.emplace(it, std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)),
+                           std::forward_as_tuple(std::forward<Args>(args)...));
+    return {it, true};
+  }
+
+  template <class... Args>
+  std::pair<iterator, bool> emplace(Args&&... args) {
+    value_type element(std::forward<Args>(args)...);
+    iterator it = lower_bound_impl(element.first);
+    if (matches(it, element.first)) return {it, false};
+    return {elements_.insert(it, std::move(element)), true};
+  }
+
+  std::pair<iterator, bool> insert(value_type const& element) { return emplace(element); }
+  std::pair<iterator, bool> insert(value_type&& element) { return emplace(std::move(element)); }
+
+  iterator erase(const_iterator position) { return elements_.erase(position); }
+  iterator erase(const_iterator first, const_iterator last) { return elements_.erase(first, last); }
+
+  size_type erase(Key const& key) {
+    iterator it = find(key);
+    if (it == end()) return 0u;
+    elements_.erase(it);
+    return 1u;
+  }
+
+  void swap(flat_object& other) noexcept {
+    using std::swap;
+    elements_.swap(other.elements_);
+    swap(compare_, other.compare_);
+  }
+
+  friend bool operator==(flat_object const& lhs, flat_object const& rhs) {
+    return lhs.elements_ == rhs.elements_;
+  }
+
+  friend bool operator!=(flat_object const& lhs, flat_object const& rhs) { return !(lhs == rhs); }
+
+  friend bool operator<(flat_object const& lhs, flat_object const& rhs) {
+    return lhs.elements_ < rhs.elements_;
+  }
+};
+}  // namespace json_backbone
+
+#endif  // JSON_BACKBONE_FLAT_OBJECT_HEADER
@@ -0,0 +1,389 @@
+#ifndef JSON_BACKBONE_HASH_HEADER
+#define JSON_BACKBONE_HASH_HEADER
+#include <json_backbone.hpp>
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace json_backbone {
+namespace hashing_helpers {
+inline std::size_t combine(std::size_t seed, std::size_t hash) noexcept {
+  return seed ^ (hash + static_cast<std::size_t>(0x9E3779B97F4A7C15ull) + (seed << 6u) + (seed >> 2u));
+}
+
+using helpers::rank;
+
+template <class T>
+std::size_t hash_value(T const& value);
+
+// Hashes the elements of an array in order
+template <class Array, class ElementHash>
+std::size_t hash_array(Array const& array, ElementHash const& element_hash) {
+  std::size_t hash = array.size();
+  for (auto const& element : array) hash = combine(hash, element_hash(element));
+  return hash;
+}
+
+// Hashes the elements of an object in any order, so that unordered objects hash alike
+template <class Object, class ElementHash>
+std::size_t hash_object(Object const& object, ElementHash const& element_hash) {
+  std::size_t sum = 0u;
+  for (auto const& element : object)
+    sum += combine(hash_value(element.first), element_hash(element.second));
+  return combine(object.size(), sum);
+}
+
+struct structural_hash {
+  template <class T>
+  std::size_t operator()(T const& value) const {
+    return hash_value(value);
+  }
+};
+
+inline std::size_t hash_of(std::nullptr_t, rank<3u>) noexcept { return 0u; }
+
+template <class T>
+auto hash_of(T const& value, rank<2u>) -> decltype(std::hash<T>{}(value)) {
+  return std::hash<T>{}(value);
+}
+
+template <class T, class Mapped = typename T::mapped_type>
+std::size_t hash_of(T const& object, rank<1u>) {
+  return hash_object(object, structural_hash{});
+}
+
+template <class T>
+auto hash_of(T const& array, rank<0u>) -> decltype(array.begin(), array.end(), std::size_t{}) {
+  return hash_array(array, structural_hash{});
+}
+
+template <class T>
+std::size_t hash_value(T const& value) {
+  return hash_of(value, rank<3u>{});
+}
+
+template <class... Value>
+std::size_t hash_variant(variant<Value...> const& value) {
+  return combine(value.type_index(), apply_visitor<std::size_t>(value, structural_hash{}));
+}
+
+//
+// Hashes a container as hash_variant would, with an explicit stack
+//
+// Arrays and objects are walked depth first, each frame folding the hashes of
+// its children as they complete, so that deeply nested containers are hashed
+// without overflowing the call stack.
+//
+template <class Container>
+std::size_t hash_container(Container const& root) {
+  using array_type = typename Container::array_type;
+  using object_type = typename Container::object_type;
+  struct frame {
+    Container const* node;
+    typename array_type::const_iterator element;
+    typename object_type::const_iterator member;
+    std::size_t hash;  // Folded hashes of arrays, sum of the element hashes of objects
+  };
+
+  std::vector<frame> stack;
+  Container const* current = &root;
+  std::size_t hash = 0u;
+  for (;;) {
+    if (current) {
+      if (current->template is<array_type>()) {
+        array_type const& array = current->template get<array_type>();
+        if (!array.empty()) {
+          stack.push_back(frame{current, array.begin(), {}, array.size()});
+          current = &*array.begin();
+          continue;
+        }
+        hash = combine(current->type_index(), 0u);
+      } else if (current->template is<object_type>()) {
+        object_type const& object = current->template get<object_type>();
+        if (!object.empty()) {
+          stack.push_back(frame{current, {}, object.begin(), 0u});
+          current = &object.begin()->second;
+          continue;
+        }
+        hash = combine(current->type_index(), combine(0u, 0u));
+      } else {
+        hash = hash_variant(*current);
+      }
+      current = nullptr;
+    }
+    if (stack.empty()) return hash;
+
+    // Folds the hash of the completed child into its parent
+    frame& top = stack.back();
+    if (top.node->template is<array_type>()) {
+      array_type const& array = top.node->template get<array_type>();
+      top.hash = combine(top.hash, hash);
+      if (++top.element != array.end()) {
+        current = &*top.element;
+        continue;
+      }
+      hash = combine(top.node->type_index(), top.hash);
+    } else {
+      object_type const& object = top.node->template get<object_type>();
+      top.hash += combine(hash_value(top.member->first), hash);
+      if (++top.member != object.end()) {
+        current = &top.member->second;
+        continue;
+      }
+      hash = combine(top.node->type_index(), combine(object.size(), top.hash));
+    }
+    stack.pop_back();
+  }
+}
+}  // namespace hashing_helpers
+
+//
+// hash_cons shares identical subtrees of containers
+//
+// intern returns a container equal to its argument whose arrays, objects and
+// heap values are taken from a table of unique nodes. Children are interned
+// first, so that nodes are compared through the identity of their children and
+// hashed from the hashes of their children, computed once per unique node.
+//
+// Subtrees are shared through the copies of heap values, containers shall
+// use the copy_on_write policy of variant_traits. Without it every node of the
+// table would be a deep copy of its subtree, for no sharing at all.
+//
+template <class Container>
+class hash_cons {
+ public:
+  using container_type = Container;
+  using array_type = typename Container::array_type;
+  using object_type = typename Container::object_type;
+
+ private:
+  static_assert(Container::traits_type::copy_on_write,
+                "hash_cons shares nodes between copies, containers shall use copy on write.");
+
+  std::unordered_multimap<std::size_t, Container> nodes_;
+  std::unordered_map<void const*, std::size_t> hashes_;  // Hashes of unique nodes by address
+
+  // Arrays and objects being interned, with the position of their next child
+  struct frame {
+    Container const* value;
+    std::size_t first;  // Position of their first interned child in children_
+    std::size_t element;
+    typename object_type::const_iterator member;
+  };
+
+  std::vector<Container> children_;  // Stack of interned children of the nodes being interned
+  std::vector<frame> frames_;
+
+  // Tells if copies of a value share its address
+  struct is_shared {
+    template <class T>
+    bool operator()(T const&) const {
+      return !Container::storage_type::template is_inline<T>::value;
+    }
+  };
+
+  struct address_of {
+    template <class T>
+    void const* operator()(T const& value) const {
+      return &value;
+    }
+  };
+
+  static bool shared(Container const& value) { return apply_visitor<bool>(value, is_shared{}); }
+
+  static void const* address(Container const& value) {
+    return apply_visitor<void const*>(value, address_of{});
+  }
+
+  // Hash of an interned value
+  std::size_t child_hash(Container const& value) const {
+    if (shared(value)) {
+      auto it = hashes_.find(address(value));
+      if (it != hashes_.end()) return it->second;
+    }
+    return std::hash<Container>{}(value);
+  }
+
+  // Compares interned values
+  static bool same_child(Container const& lhs, Container const& rhs) {
+    return lhs.type_index() == rhs.type_index() &&
+           (shared(lhs) ? address(lhs) == address(rhs) : lhs == rhs);
+  }
+
+  // Compares a unique node with value, whose interned children are on the stack from first
+  bool same_node(Container const& node, Container const& value, std::size_t first) const {
+    if (node.type_index() != value.type_index()) return false;
+    if (value.template is<array_type>()) {
+      array_type const& array = node.template get<array_type>();
+      return array.size() == children_.size() - first &&
+             std::equal(array.begin(), array.end(), children_.begin() + first, same_child);
+    }
+    object_type const& object = node.template get<object_type>();
+    if (object.size() != children_.size() - first) return false;
+    std::size_t index = first;
+    for (auto const& element : value.template get<object_type>()) {
+      auto it = object.find(element.first);
+      if (it == object.end() || !same_child(it->second, children_[index++])) return false;
+    }
+    return true;
+  }
+
+  // Hashes value as std::hash would, from the hashes of its interned children
+  std::size_t node_hash(Container const& value, std::size_t first) const {
+    std::size_t const size = children_.size() - first;
+    std::size_t hash = size;
+    if (value.template is<array_type>()) {
+      for (std::size_t index = first; index < children_.size(); ++index)
+        hash = hashing_helpers::combine(hash, child_hash(children_[index]));
+    } else {
+      std::size_t sum = 0u, index = first;
+      for (auto const& element : value.template get<object_type>())
+        sum += hashing_helpers::combine(hashing_helpers::hash_value(element.first),
+                                        child_hash(children_[index++]));
+      hash = hashing_helpers::combine(size, sum);
+    }
+    return hashing_helpers::combine(value.type_index(), hash);
+  }
+
+  // Builds a unique node from value, moving its interned children out of the stack
+  Container make_node(Container const& value, std::size_t first) {
+    if (value.template is<array_type>()) {
+      array_type array;
+      array.reserve(children_.size() - first);
+      for (std::size_t index = first; index < children_.size(); ++index)
+        array.push_back(std::move(children_[index]));
+      return Container{std::move(array)};
+    }
+    object_type object;
+    std::size_t index = first;
+    for (auto const& element : value.template get<object_type>())
+      object.emplace(element.first, std::move(children_[index++]));
+    return Container{std::move(object)};
+  }
+
+  Container insert(std::size_t hash, Container&& node) {
+    auto it = nodes_.emplace(hash, std::move(node));
+    if (shared(it->second)) hashes_.emplace(address(it->second), hash);
+    return it->second;
+  }
+
+  Container intern_leaf(Container const& value) {
+    if (!shared(value) || hashes_.count(address(value))) return value;
+    std::size_t const hash = std::hash<Container>{}(value);
+    auto range = nodes_.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it)
+      if (it->second == value) return it->second;
+    return insert(hash, Container{value});
+  }
+
+  // Pushes the interned value of a leaf or of a known node, or opens a frame for its children
+  void enter(Container const& value) {
+    bool const is_array = value.template is<array_type>();
+    if (!is_array && !value.template is<object_type>()) {
+      children_.push_back(intern_leaf(value));
+    } else if (shared(value) && hashes_.count(address(value))) {
+      children_.push_back(value);
+    } else {
+      frames_.push_back(frame{&value, children_.size(), 0u,
+                              is_array ? typename object_type::const_iterator{}
+                                       : value.template get<object_type>().begin()});
+    }
+  }
+
+  // Returns the unique node equal to value, whose interned children are on the stack from first
+  Container close(Container const& value, std::size_t first) {
+    std::size_t const hash = node_hash(value, first);
+    auto range = nodes_.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (same_node(it->second, value, first)) {
+        children_.resize(first);
+        return it->second;
+      }
+    }
+    Container node = make_node(value, first);
+    children_.resize(first);
+    return insert(hash, std::move(node));
+  }
+
+ public:
+  // Returns a container equal to value, sharing its subtrees with previously interned ones
+  //
+  // Nodes are interned depth first with explicit stacks rather than by recursion,
+  // so that deeply nested containers are interned without overflowing the call stack.
+  Container intern(Container const& value) {
+    std::size_t const depth = frames_.size();
+    std::size_t const base = children_.size();
+    try {
+      enter(value);
+      while (depth < frames_.size()) {
+        frame& top = frames_.back();
+        Container const& node = *top.value;
+        if (node.template is<array_type>()) {
+          array_type const& array = node.template get<array_type>();
+          if (top.element < array.size()) {
+            enter(array[top.element++]);
+            continue;
+          }
+        } else {
+          object_type const& object = node.template get<object_type>();
+          if (top.member != object.end()) {
+            Container const& child = top.member->second;
+            ++top.member;
+            enter(child);
+            continue;
+          }
+        }
+        std::size_t const first = top.first;
+        frames_.pop_back();
+        Container result = close(node, first);
+        children_.push_back(std::move(result));
+      }
+    } catch (...) {
+      frames_.resize(depth);
+      children_.resize(base);
+      throw;
+    }
+    Container result = std::move(children_.back());
+    children_.pop_back();
+    return result;
+  }
+
+  // Number of unique nodes
+  std::size_t size() const noexcept { return nodes_.size(); }
+
+  void clear() noexcept {
+    nodes_.clear();
+    hashes_.clear();
+    children_.clear();
+    frames_.clear();
+  }
+};
+}  // namespace json_backbone
+
+namespace std {
+//
+// Structural hashes of variants and containers
+//
+// Equal values have equal hashes. Objects hash their elements in any order,
+// so that unordered object types hash consistently with their equality.
+// Containers are hashed with an explicit stack rather than by recursion.
+//
+template <class... Value>
+struct hash<json_backbone::variant<Value...>> {
+  std::size_t operator()(json_backbone::variant<Value...> const& value) const {
+    return json_backbone::hashing_helpers::hash_variant(value);
+  }
+};
+
+template <template <class...> class Object, template <class...> class Array, class Key,
+          class... Value>
+struct hash<json_backbone::container<Object, Array, Key, Value...>> {
+  std::size_t operator()(json_backbone::container<Object, Array, Key, Value...> const& value) const {
+    return json_backbone::hashing_helpers::hash_container(value);
+  }
+};
+}  // namespace std
+
+#endif  // JSON_BACKBONE_HASH_HEADER
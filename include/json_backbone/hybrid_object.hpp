@@ -0,0 +1,380 @@
+#ifndef JSON_BACKBONE_HYBRID_OBJECT_HEADER
+#define JSON_BACKBONE_HYBRID_OBJECT_HEADER
+#include <json_backbone/text.hpp>
+#include <json_backbone/transparent.hpp>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && 2 <= _M_IX86_FP)
+#include <emmintrin.h>
+#define JSON_BACKBONE_HYBRID_SSE2 1
+#endif
+
+namespace json_backbone {
+namespace object_helpers {
+//
+// control_group matches 16 control bytes of an open addressing table at once
+//
+// A control byte is empty, deleted or holds the 7 low bits of a key hash.
+// Matches are returned as a bit mask, bit i standing for byte i.
+//
+struct control_group {
+  static constexpr std::size_t width = 16u;
+  static constexpr std::int8_t empty = -128;
+  static constexpr std::int8_t deleted = -2;
+
+#if defined(JSON_BACKBONE_HYBRID_SSE2)
+  __m128i bytes;
+
+  explicit control_group(std::int8_t const* position)
+      : bytes{_mm_loadu_si128(reinterpret_cast<__m128i const*>(position))} {}
+
+  std::uint32_t match(std::int8_t value) const noexcept {
+    return static_cast<std::uint32_t>(
+        _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(value))));
+  }
+#else
+  std::int8_t bytes[width];
+
+  explicit control_group(std::int8_t const* position) { std::memcpy(bytes, position, width); }
+
+  std::uint32_t match(std::int8_t value) const noexcept {
+    std::uint32_t mask = 0u;
+    for (std::size_t index = 0; index < width; ++index)
+      mask |= static_cast<std::uint32_t>(bytes[index] == value) << index;
+    return mask;
+  }
+#endif
+
+  std::uint32_t match_empty() const noexcept { return match(empty); }
+};
+}  // namespace object_helpers
+
+//
+// hybrid_object is an associative container tuned for both tiny and huge objects
+//
+// Elements are stored densely in insertion order. Up to small_size elements,
+// lookup is a linear scan of the keys. Beyond, an open addressing index is
+// built: slots are probed by groups of 16 control bytes holding 7 bits of the
+// key hashes, matched at once with SSE2 when available. It can be used as the
+// ObjectBase of a container:
+//
+// container<hybrid_object, std::vector, std::string, ...>
+//
+// value_type is std::pair<Key, Value>, keys must not be modified through
+// iterators. Erasing an element moves the last one in its place. std::string
+// keys are hashed with the transparent string_hash by default, so that they are
+// looked up without being converted to Key.
+//
+template <class Key, class Value, class Hash = default_hash_t<Key>, class KeyEqual = std::equal_to<>,
+          class Allocator = std::allocator<std::pair<Key, Value>>>
+class hybrid_object {
+ public:
+  using key_type = Key;
+  using mapped_type = Value;
+  using value_type = std::pair<Key, Value>;
+  using hasher = Hash;
+  using key_equal = KeyEqual;
+  using allocator_type = Allocator;
+  using storage_type = std::vector<value_type, Allocator>;
+  using size_type = typename storage_type::size_type;
+  using difference_type = typename storage_type::difference_type;
+  using reference = value_type&;
+  using const_reference = value_type const&;
+  using iterator = typename storage_type::iterator;
+  using const_iterator = typename storage_type::const_iterator;
+
+  // Number of elements up to which no index is built
+  static constexpr std::size_t small_size = 8u;
+
+ private:
+  using group = object_helpers::control_group;
+  using index_type = std::uint32_t;
+  static constexpr index_type no_element = ~index_type{0};
+
+  storage_type elements_;
+  std::vector<std::int8_t> control_;  // Empty until the index is built
+  std::vector<index_type> slots_;
+  std::size_t used_slots_ = 0u;  // Full and deleted slots
+  Hash hash_;
+  KeyEqual equal_;
+
+  static constexpr bool transparent =
+      is_transparent<Hash>::value && is_transparent<KeyEqual>::value;
+
+  // Type keys are looked up as, converted once to Key unless lookup is transparent
+  template <class K>
+  using lookup_t = std::conditional_t<transparent, K, Key>;
+
+  template <class K>
+  std::size_t mixed_hash(K const& key) const {
+    // Spread weak hashes, such as the identity of integers, over every bit
+    std::uint64_t hash = static_cast<std::uint64_t>(hash_(key)) * 0x9E3779B97F4A7C15ull;
+    return static_cast<std::size_t>(hash ^ (hash >> 32u));
+  }
+
+  static std::int8_t fingerprint(std::size_t hash) noexcept {
+    return static_cast<std::int8_t>(hash & 0x7Fu);
+  }
+
+  std::size_t group_mask() const noexcept { return control_.size() / group::width - 1u; }
+
+  // Returns the slot holding the element at index, or of key when index is no_element
+  template <class K>
+  std::size_t find_slot(K const& key, std::size_t hash, index_type index) const {
+    std::size_t position = (hash >> 7u) & group_mask();
+    for (std::size_t probe = 1u;; ++probe) {
+      group const current{control_.data() + position * group::width};
+      for (std::uint32_t mask = current.match(fingerprint(hash)); mask; mask &= mask - 1u) {
+        std::size_t slot = position * group::width + text_helpers::lowest_bit(mask);
+        index_type candidate = slots_[slot];
+        if (index == no_element ? equal_(elements_[candidate].first, key) : candidate == index)
+          return slot;
+      }
+      if (current.match_empty()) return control_.size();
+      position = (position + probe) & group_mask();
+    }
+  }
+
+  template <class K>
+  std::size_t find_index(K const& key) const {
+    if (control_.empty()) {
+      for (std::size_t index = 0; index < elements_.size(); ++index)
+        if (equal_(elements_[index].first, key)) return index;
+      return elements_.size();
+    }
+    std::size_t slot = find_slot(key, mixed_hash(key), no_element);
+    return slot == control_.size() ? elements_.size() : slots_[slot];
+  }
+
+  void insert_slot(std::size_t hash, index_type index) {
+    std::size_t position = (hash >> 7u) & group_mask();
+    for (std::size_t probe = 1u;; ++probe) {
+      group const current{control_.data() + position * group::width};
+      std::uint32_t mask = current.match_empty() | current.match(group::deleted);
+      if (mask) {
+        std::size_t slot = position * group::width + text_helpers::lowest_bit(mask);
+        if (control_[slot] == group::empty) ++used_slots_;
+        control_[slot] = fingerprint(hash);
+        slots_[slot] = index;
+        return;
+      }
+      position = (position + probe) & group_mask();
+    }
+  }
+
+  // Rebuilds the index with room for at least size elements
+  void rehash(std::size_t size) {
+    std::size_t capacity = group::width;
+    while (capacity * 7u / 8u < size) capacity *= 2u;
+    // Both arrays are allocated before replacing the index, which stays consistent on failure
+    std::vector<std::int8_t> control(capacity, std::int8_t{group::empty});
+    std::vector<index_type> slots(capacity, no_element);
+    control_.swap(control);
+    slots_.swap(slots);
+    used_slots_ = 0u;
+    try {
+      for (std::size_t index = 0; index < elements_.size(); ++index)
+        insert_slot(mixed_hash(elements_[index].first), static_cast<index_type>(index));
+    } catch (...) {
+      // A throwing hash leaves the elements unindexed, looked up by linear scans
+      control_.clear();
+      slots_.clear();
+      used_slots_ = 0u;
+      throw;
+    }
+  }
+
+  // Indexes the last element
+  void index_back() {
+    if (control_.empty()) {
+      if (small_size < elements_.size()) rehash(elements_.size() * 2u);
+    } else if (control_.size() * 7u / 8u <= used_slots_) {
+      rehash(elements_.size() * 2u);
+    } else {
+      insert_slot(mixed_hash(elements_.back().first),
+                  static_cast<index_type>(elements_.size() - 1u));
+    }
+  }
+
+  void erase_index(std::size_t index) {
+    if (!control_.empty()) {
+      std::size_t slot =
+          find_slot(elements_[index].first, mixed_hash(elements_[index].first),
+                    static_cast<index_type>(index));
+      control_[slot] = group::deleted;
+      std::size_t last = elements_.size() - 1u;
+      if (index != last) {
+        slots_[find_slot(elements_[last].first, mixed_hash(elements_[last].first),
+                         static_cast<index_type>(last))] = static_cast<index_type>(index);
+      }
+    }
+    if (index + 1u != elements_.size()) elements_[index] = std::move(elements_.back());
+    elements_.pop_back();
+  }
+
+ public:
+  hybrid_object() = default;
+
+  explicit hybrid_object(Allocator const& allocator) : elements_(allocator) {}
+
+  hybrid_object(std::initializer_list<std::pair<Key const, Value>> elements,
+                Allocator const& allocator = Allocator())
+      : elements_(allocator) {
+    reserve(elements.size());
+    for (auto const& element : elements) try_emplace(element.first, element.second);
+  }
+
+  template <class InputIterator>
+  hybrid_object(InputIterator first, InputIterator last, Allocator const& allocator = Allocator())
+      : elements_(allocator) {
+    for (; first != last; ++first) try_emplace(first->first, first->second);
+  }
+
+  allocator_type get_allocator() const { return elements_.get_allocator(); }
+  hasher hash_function() const { return hash_; }
+  key_equal key_eq() const { return equal_; }
+
+  iterator begin() noexcept { return elements_.begin(); }
+  const_iterator begin() const noexcept { return elements_.begin(); }
+  const_iterator cbegin() const noexcept { return elements_.cbegin(); }
+  iterator end() noexcept { return elements_.end(); }
+  const_iterator end() const noexcept { return elements_.end(); }
+  const_iterator cend() const noexcept { return elements_.cend(); }
+
+  bool empty() const noexcept { return elements_.empty(); }
+  size_type size() const noexcept { return elements_.size(); }
+
+  // Tells if lookups use the index rather than a linear scan
+  bool indexed() const noexcept { return !control_.empty(); }
+
+  void reserve(size_type size) {
+    elements_.reserve(size);
+    if (small_size < size && control_.size() * 7u / 8u < size) rehash(size);
+  }
+
+  void clear() noexcept {
+    elements_.clear();
+    control_.clear();
+    slots_.clear();
+    used_slots_ = 0u;
+  }
+
+  iterator find(Key const& key) { return elements_.begin() + find_index(key); }
+  const_iterator find(Key const& key) const { return elements_.begin() + find_index(key); }
+
+  template <class K, bool Transparent = transparent, class = std::enable_if_t<Transparent>>
+  iterator find(K const& key) {
+    return elements_.begin() + find_index(key);
+  }
+
+  template <class K, bool Transparent = transparent, class = std::enable_if_t<Transparent>>
+  const_iterator find(K const& key) const {
+    return elements_.begin() + find_index(key);
+  }
+
+  size_type count(Key const& key) const { return find_index(key) == elements_.size() ? 0u : 1u; }
+
+  template <class K, bool Transparent = transparent, class = std::enable_if_t<Transparent>>
+  size_type count(K const& key) const {
+    return find_index(key) == elements_.size() ? 0u : 1u;
+  }
+
+  Value& at(Key const& key) {
+    iterator it = find(key);
+    if (it == end()) throw std::out_of_range("hybrid_object::at");
+    return it->second;
+  }
+
+  Value const& at(Key const& key) const {
+    const_iterator it = find(key);
+    if (it == end()) throw std::out_of_range("hybrid_object::at");
+    return it->second;
+  }
+
+  Value& operator[](Key const& key) { return try_emplace(key).first->second; }
+  Value& operator[](Key&& key) { return try_emplace(std::move(key)).first->second; }
+
+  // Constructs the value in place if key does not exist yet
+  template <class K, class... Args>
+  std::pair<iterator, bool> try_emplace(K&& key, Args&&... args) {
+    lookup_t<std::decay_t<K>> const& lookup = key;
+    std::size_t index = find_index(lookup);
+    if (index != elements_.size()) return {elements_.begin() + index, false};
+    elements_.emplace_back(std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)),
+                           std::forward_as_tuple(std::forward<Args>(args)...));
+    try {
+      index_back();
+    } catch (...) {
+      elements_.pop_back();
+      throw;
+    }
+    return {elements_.begin() + index, true};
+  }
+
+  template <class... Args>
+  std::pair<iterator, bool> emplace(Args&&... args) {
+    value_type element(std::forward<Args>(args)...);
+    return try_emplace(std::move(element.first), std::move(element.second));
+  }
+
+  std::pair<iterator, bool> insert(value_type const& element) { return emplace(element); }
+  std::pair<iterator, bool> insert(value_type&& element) { return emplace(std::move(element)); }
+
+  // Erases the element at position, the last element is moved in its place
+  iterator erase(const_iterator position) {
+    std::size_t index = static_cast<std::size_t>(position - elements_.cbegin());
+    erase_index(index);
+    return elements_.begin() + index;
+  }
+
+  size_type erase(Key const& key) {
+    std::size_t index = find_index(key);
+    if (index == elements_.size()) return 0u;
+    erase_index(index);
+    return 1u;
+  }
+
+  void swap(hybrid_object& other) noexcept {
+    using std::swap;
+    elements_.swap(other.elements_);
+    control_.swap(other.control_);
+    slots_.swap(other.slots_);
+    swap(used_slots_, other.used_slots_);
+    swap(hash_, other.hash_);
+    swap(equal_, other.equal_);
+  }
+
+  // Objects are equal if they hold the same elements, whatever their order
+  friend bool operator==(hybrid_object const& lhs, hybrid_object const& rhs) {
+    if (lhs.size() != rhs.size()) return false;
+    for (auto const& element : lhs) {
+      auto it = rhs.find(element.first);
+      if (it == rhs.end() || !(it->second == element.second)) return false;
+    }
+    return true;
+  }
+
+  friend bool operator!=(hybrid_object const& lhs, hybrid_object const& rhs) {
+    return !(lhs == rhs);
+  }
+};
+
+template <class Key, class Value, class Hash, class KeyEqual, class Allocator>
+constexpr std::size_t hybrid_object<Key, Value, Hash, KeyEqual, Allocator>::small_size;
+
+template <class Key, class Value, class Hash, class KeyEqual, class Allocator>
+constexpr bool hybrid_object<Key, Value, Hash, KeyEqual, Allocator>::transparent;
+
+template <class Key, class Value, class Hash, class KeyEqual, class Allocator>
+constexpr typename hybrid_object<Key, Value, Hash, KeyEqual, Allocator>::index_type
+    hybrid_object<Key, Value, Hash, KeyEqual, Allocator>::no_element;
+}  // namespace json_backbone
+
+#endif  // JSON_BACKBONE_HYBRID_OBJECT_HEADER
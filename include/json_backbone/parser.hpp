@@ -0,0 +1,421 @@
+#ifndef JSON_BACKBONE_PARSER_HEADER
+#define JSON_BACKBONE_PARSER_HEADER
+#include <json_backbone.hpp>
+#include <json_backbone/text.hpp>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace json_backbone {
+class parse_error : public std::logic_error {
+  std::size_t offset_;
+
+ public:
+  parse_error(std::string const& message, std::size_t offset)
+      : std::logic_error{message + " at offset " + std::to_string(offset)}, offset_{offset} {}
+
+  // Offset of the faulty character in the parsed text
+  std::size_t offset() const noexcept { return offset_; }
+};
+
+namespace parser_helpers {
+// Appends the UTF-8 encoding of a code point
+inline void append_utf8(std::string& output, std::uint32_t code_point) {
+  if (code_point < 0x80u) {
+    output.push_back(static_cast<char>(code_point));
+  } else if (code_point < 0x800u) {
+    output.push_back(static_cast<char>(0xC0u | (code_point >> 6u)));
+    output.push_back(static_cast<char>(0x80u | (code_point & 0x3Fu)));
+  } else if (code_point < 0x10000u) {
+    output.push_back(static_cast<char>(0xE0u | (code_point >> 12u)));
+    output.push_back(static_cast<char>(0x80u | ((code_point >> 6u) & 0x3Fu)));
+    output.push_back(static_cast<char>(0x80u | (code_point & 0x3Fu)));
+  } else {
+    output.push_back(static_cast<char>(0xF0u | (code_point >> 18u)));
+    output.push_back(static_cast<char>(0x80u | ((code_point >> 12u) & 0x3Fu)));
+    output.push_back(static_cast<char>(0x80u | ((code_point >> 6u) & 0x3Fu)));
+    output.push_back(static_cast<char>(0x80u | (code_point & 0x3Fu)));
+  }
+}
+
+using helpers::rank;
+
+// Constructs an element in place unless its key exists, using try_emplace when available
+template <class Object, class Key, class... Args>
+auto emplace_element(rank<1u>, Object& object, Key&& key, Args&&... args)
+    -> decltype(object.try_emplace(std::forward<Key>(key), std::forward<Args>(args)...), void()) {
+  object.try_emplace(std::forward<Key>(key), std::forward<Args>(args)...);
+}
+
+template <class Object, class Key, class... Args>
+void emplace_element(rank<0u>, Object& object, Key&& key, Args&&... args) {
+  object.emplace(std::piecewise_construct, std::forward_as_tuple(std::forward<Key>(key)),
+                 std::forward_as_tuple(std::forward<Args>(args)...));
+}
+}  // namespace parser_helpers
+
+//
+// parser builds containers from JSON texts (RFC 8259)
+//
+// Values are built directly into the container, without an intermediate
+// document, and nesting is tracked with explicit stacks rather than by
+// recursion. Whitespace and string contents are scanned 16 characters at a
+// time with SSE2 when available. A parser keeps its stacks and buffers
+// between calls, reuse it to parse many texts.
+//
+// Numbers take the alternative the container would select for a C++ value
+// of the same kind: integers are constructed from the narrowest of int, long
+// long and unsigned long long holding them, other numbers from a double.
+// Strings are constructed from a character pointer and a size, keys as well.
+// Duplicated keys keep their first value. Numbers which cannot be converted
+// exactly on the fast path are converted with std::strtod, which assumes the
+// "C" numeric locale. Strings are not checked to be valid UTF-8.
+//
+template <class Container>
+class parser {
+ public:
+  using container_type = Container;
+  using array_type = typename Container::array_type;
+  using object_type = typename Container::object_type;
+  using key_type = typename object_type::key_type;
+
+ private:
+  enum class frame : char { array, object };
+
+  char const* begin_ = nullptr;
+  char const* position_ = nullptr;
+  char const* end_ = nullptr;
+  std::vector<frame> frames_;
+  std::vector<array_type> arrays_;
+  std::vector<object_type> objects_;
+  std::vector<key_type> keys_;
+  std::string buffer_;  // Unescaped strings and numbers handed to strtod
+  Container root_;
+
+  [[noreturn]] void fail(char const* message) const {
+    throw parse_error(message, static_cast<std::size_t>(position_ - begin_));
+  }
+
+  void skip_whitespace() noexcept { position_ = text_helpers::skip_whitespace(position_, end_); }
+
+  void expect(char value, char const* message) {
+    skip_whitespace();
+    if (position_ == end_ || value != *position_) fail(message);
+    ++position_;
+  }
+
+  // Parses a string starting after its opening quote, returns its content range
+  std::pair<char const*, std::size_t> parse_string() {
+    char const* first = position_;
+    position_ = text_helpers::skip_string_plain(position_, end_);
+    if (position_ != end_ && '"' == *position_)
+      return {first, static_cast<std::size_t>(position_++ - first)};
+
+    buffer_.assign(first, position_);
+    for (;;) {
+      if (position_ == end_) fail("Unterminated string");
+      char const value = *position_;
+      if ('"' == value) {
+        ++position_;
+        return {buffer_.data(), buffer_.size()};
+      }
+      if ('\\' != value) fail("Control character in string");
+      if (++position_ == end_) fail("Unterminated string");
+      switch (*position_++) {
+        case '"':
+          buffer_.push_back('"');
+          break;
+        case '\\':
+          buffer_.push_back('\\');
+          break;
+        case '/':
+          buffer_.push_back('/');
+          break;
+        case 'b':
+          buffer_.push_back('\b');
+          break;
+        case 'f':
+          buffer_.push_back('\f');
+          break;
+        case 'n':
+          buffer_.push_back('\n');
+          break;
+        case 'r':
+          buffer_.push_back('\r');
+          break;
+        case 't':
+          buffer_.push_back('\t');
+          break;
+        case 'u':
+          parser_helpers::append_utf8(buffer_, parse_code_point());
+          break;
+        default:
+          --position_;
+          fail("Bad escape sequence");
+      }
+      char const* plain = position_;
+      position_ = text_helpers::skip_string_plain(position_, end_);
+      buffer_.append(plain, position_);
+    }
+  }
+
+  std::uint32_t parse_hex4() {
+    if (end_ - position_ < 4) fail("Bad unicode escape");
+    std::uint32_t value = 0u;
+    for (int digit = 0; digit < 4; ++digit, ++position_) {
+      char const c = *position_;
+      value <<= 4u;
+      if ('0' <= c && c <= '9') {
+        value |= static_cast<std::uint32_t>(c - '0');
+      } else if ('a' <= c && c <= 'f') {
+        value |= static_cast<std::uint32_t>(c - 'a' + 10);
+      } else if ('A' <= c && c <= 'F') {
+        value |= static_cast<std::uint32_t>(c - 'A' + 10);
+      } else {
+        fail("Bad unicode escape");
+      }
+    }
+    return value;
+  }
+
+  // Parses the code point of a \u escape, joining surrogate pairs
+  std::uint32_t parse_code_point() {
+    std::uint32_t const high = parse_hex4();
+    if (high < 0xD800u || 0xDFFFu < high) return high;
+    if (0xDC00u <= high || end_ - position_ < 2 || '\\' != position_[0] || 'u' != position_[1])
+      fail("Bad surrogate pair");
+    position_ += 2;
+    std::uint32_t const low = parse_hex4();
+    if (low < 0xDC00u || 0xDFFFu < low) fail("Bad surrogate pair");
+    return 0x10000u + ((high - 0xD800u) << 10u) + (low - 0xDC00u);
+  }
+
+  template <class T>
+  void parse_literal(char const* literal, std::size_t size, T value) {
+    if (static_cast<std::size_t>(end_ - position_) < size ||
+        0 != std::memcmp(position_, literal, size))
+      fail("Bad literal");
+    position_ += size;
+    store(value);
+  }
+
+  // Accumulates up to 19 significant digits, or 20 as long as they fit in 64 bits, the
+  // exponent keeps track of the others
+  bool parse_digits(std::uint64_t& mantissa, int& digits, int& exponent, bool& truncated,
+                    bool fraction) {
+    char const* first = position_;
+    for (; position_ != end_ && '0' <= *position_ && *position_ <= '9'; ++position_) {
+      std::uint64_t const digit = static_cast<std::uint64_t>(*position_ - '0');
+      if (digits < 19 ||
+          (19 == digits && mantissa <= (std::numeric_limits<std::uint64_t>::max() - digit) / 10u)) {
+        mantissa = mantissa * 10u + digit;
+        if (mantissa) ++digits;
+        if (fraction) --exponent;
+      } else {
+        truncated = truncated || '0' != *position_;
+        if (!fraction) ++exponent;
+      }
+    }
+    return first != position_;
+  }
+
+  void parse_number() {
+    char const* first = position_;
+    bool const negative = '-' == *position_;
+    if (negative) ++position_;
+
+    std::uint64_t mantissa = 0u;
+    int digits = 0, exponent = 0;
+    bool truncated = false;
+    bool const leading_zero = position_ != end_ && '0' == *position_;
+    if (!parse_digits(mantissa, digits, exponent, truncated, false)) fail("Bad number");
+    if (leading_zero && 1 < position_ - first - negative) fail("Bad number");
+    bool const integral = 0 == exponent && (position_ == end_ || ('.' != *position_ &&
+                                                                  'e' != *position_ &&
+                                                                  'E' != *position_));
+
+    if (integral) {
+      if (negative) {
+        if (mantissa <= static_cast<std::uint64_t>(std::numeric_limits<int>::max()) + 1u)
+          return store(static_cast<int>(-static_cast<long long>(mantissa)));
+        if (mantissa <= static_cast<std::uint64_t>(std::numeric_limits<long long>::max()) + 1u)
+          return store(-static_cast<long long>(mantissa - 1u) - 1);
+        return store(-static_cast<double>(mantissa));
+      }
+      if (mantissa <= static_cast<std::uint64_t>(std::numeric_limits<int>::max()))
+        return store(static_cast<int>(mantissa));
+      if (mantissa <= static_cast<std::uint64_t>(std::numeric_limits<long long>::max()))
+        return store(static_cast<long long>(mantissa));
+      return store(static_cast<unsigned long long>(mantissa));
+    }
+
+    if (position_ != end_ && '.' == *position_) {
+      ++position_;
+      if (!parse_digits(mantissa, digits, exponent, truncated, true)) fail("Bad number");
+    }
+    if (position_ != end_ && ('e' == *position_ || 'E' == *position_)) {
+      ++position_;
+      bool const negative_exponent = position_ != end_ && '-' == *position_;
+      if (position_ != end_ && ('-' == *position_ || '+' == *position_)) ++position_;
+      if (position_ == end_ || *position_ < '0' || '9' < *position_) fail("Bad number");
+      int value = 0;
+      for (; position_ != end_ && '0' <= *position_ && *position_ <= '9'; ++position_)
+        if (value < 100000) value = value * 10 + (*position_ - '0');
+      exponent += negative_exponent ? -value : value;
+    }
+
+    // Exact when both the mantissa and the power of ten are exact doubles
+    if (!truncated && mantissa <= (std::uint64_t{1} << 53u) && -22 <= exponent && exponent <= 22) {
+      double value = static_cast<double>(mantissa);
+      value = exponent < 0 ? value / text_helpers::exact_power_of_ten(-exponent)
+                           : value * text_helpers::exact_power_of_ten(exponent);
+      return store(negative ? -value : value);
+    }
+    buffer_.assign(first, position_);
+    store(std::strtod(buffer_.c_str(), nullptr));
+  }
+
+  // Parses an object key and the following colon
+  void parse_key() {
+    expect('"', "Expected a key");
+    auto const key = parse_string();
+    keys_.emplace_back(key.first, key.second);
+    expect(':', "Expected ':'");
+  }
+
+  // Constructs a value in place, in the collection being parsed or as the root
+  template <class... Args>
+  void store(Args&&... args) {
+    if (frames_.empty()) {
+      root_ = Container(std::forward<Args>(args)...);
+    } else if (frame::array == frames_.back()) {
+      arrays_.back().emplace_back(std::forward<Args>(args)...);
+    } else {
+      parser_helpers::emplace_element(parser_helpers::rank<1u>{}, objects_.back(),
+                                      std::move(keys_.back()), std::forward<Args>(args)...);
+      keys_.pop_back();
+    }
+  }
+
+  void clear() noexcept {
+    frames_.clear();
+    arrays_.clear();
+    objects_.clear();
+    keys_.clear();
+  }
+
+  void parse_document() {
+    for (;;) {
+      // Parses a value, or opens a collection and parses its first value
+      skip_whitespace();
+      if (position_ == end_) fail("Expected a value");
+      switch (*position_) {
+        case '{':
+          ++position_;
+          skip_whitespace();
+          if (position_ != end_ && '}' == *position_) {
+            ++position_;
+            store(object_type{});
+            break;
+          }
+          frames_.push_back(frame::object);
+          objects_.emplace_back();
+          parse_key();
+          continue;
+        case '[':
+          ++position_;
+          skip_whitespace();
+          if (position_ != end_ && ']' == *position_) {
+            ++position_;
+            store(array_type{});
+            break;
+          }
+          frames_.push_back(frame::array);
+          arrays_.emplace_back();
+          continue;
+        case '"': {
+          ++position_;
+          auto const text = parse_string();
+          store(text.first, text.second);
+          break;
+        }
+        case 't':
+          parse_literal("true", 4u, true);
+          break;
+        case 'f':
+          parse_literal("false", 5u, false);
+          break;
+        case 'n':
+          parse_literal("null", 4u, nullptr);
+          break;
+        default:
+          if ('-' != *position_ && (*position_ < '0' || '9' < *position_)) fail("Expected a value");
+          parse_number();
+      }
+
+      // Reads separators after the value, storing every collection it completes
+      for (;;) {
+        skip_whitespace();
+        if (frames_.empty()) {
+          if (position_ != end_) fail("Trailing characters");
+          return;
+        }
+        char const separator = position_ == end_ ? '\0' : *position_++;
+        if (frame::array == frames_.back()) {
+          if (',' == separator) break;
+          if (']' != separator) fail("Expected ',' or ']'");
+          array_type array = std::move(arrays_.back());
+          arrays_.pop_back();
+          frames_.pop_back();
+          store(std::move(array));
+        } else {
+          if (',' == separator) {
+            parse_key();
+            break;
+          }
+          if ('}' != separator) fail("Expected ',' or '}'");
+          object_type object = std::move(objects_.back());
+          objects_.pop_back();
+          frames_.pop_back();
+          store(std::move(object));
+        }
+      }
+    }
+  }
+
+ public:
+  Container parse(char const* text, std::size_t size) {
+    begin_ = position_ = text;
+    end_ = text + size;
+    clear();
+    try {
+      parse_document();
+    } catch (...) {
+      clear();
+      throw;
+    }
+    return std::move(root_);
+  }
+
+  Container parse(std::string const& text) { return parse(text.data(), text.size()); }
+};
+
+// Parses a JSON text into a container
+template <class Container>
+Container parse(char const* text, std::size_t size) {
+  return parser<Container>{}.parse(text, size);
+}
+
+template <class Container>
+Container parse(std::string const& text) {
+  return parser<Container>{}.parse(text.data(), text.size());
+}
+}  // namespace json_backbone
+
+#endif  // JSON_BACKBONE_PARSER_HEADER
@@ -0,0 +1,149 @@
+#ifndef JSON_BACKBONE_PATH_HEADER
+#define JSON_BACKBONE_PATH_HEADER
+#include <json_backbone.hpp>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace json_backbone {
+struct bad_path : std::logic_error {
+  using std::logic_error::logic_error;
+};
+
+//
+// path is a compiled sequence of keys and indices resolved against a container
+//
+// A path is parsed once from a JSON Pointer (RFC 6901) or built fluently, then
+// resolved many times. Keys are converted to the key_type of the container when
+// the path is built, so that resolution neither allocates nor builds temporary
+// views. As view does, resolution returns an empty view on any miss:
+//
+// path<json_container> const p{"/a/b/3/c"};  // Same as path<json_container>{}["a"]["b"][3]["c"]
+// std::string name = p(c).get<std::string>(default_name);
+//
+// A numeric segment of a pointer is an index in arrays and a key in objects.
+//
+template <class Container>
+class path {
+ public:
+  using container_type = Container;
+  using key_type = typename Container::object_type::key_type;
+  using object_type = typename Container::object_type;
+  using array_type = typename Container::array_type;
+
+ private:
+  struct step {
+    key_type key;
+    std::size_t index;
+    bool has_key;
+    bool has_index;
+  };
+
+  std::vector<step> steps_;
+
+  // Returns the array index written in a pointer segment, if any and if it fits a size_t
+  static bool parse_index(std::string const& segment, std::size_t& index) {
+    if (segment.empty() || (1u < segment.size() && '0' == segment[0])) return false;
+    index = 0u;
+    for (char digit : segment) {
+      if (digit < '0' || '9' < digit) return false;
+      std::size_t const value = static_cast<std::size_t>(digit - '0');
+      if ((std::numeric_limits<std::size_t>::max() - value) / 10u < index) return false;
+      index = index * 10u + value;
+    }
+    return true;
+  }
+
+  void parse(std::string const& pointer) {
+    if (pointer.empty()) return;
+    if ('/' != pointer[0])
+      throw bad_path("Bad path, a JSON pointer shall be empty or start with '/'.");
+    std::string segment;
+    for (std::size_t position = 1u; position <= pointer.size(); ++position) {
+      if (position == pointer.size() || '/' == pointer[position]) {
+        std::size_t index = 0u;
+        bool has_index = parse_index(segment, index);
+        steps_.push_back(step{key_type(segment), index, true, has_index});
+        segment.clear();
+      } else if ('~' == pointer[position]) {
+        char escaped = position + 1u < pointer.size() ? pointer[++position] : '\0';
+        if ('0' != escaped && '1' != escaped)
+          throw bad_path("Bad path, '~' shall be followed by '0' or '1' in a JSON pointer.");
+        segment += '0' == escaped ? '~' : '/';
+      } else {
+        segment += pointer[position];
+      }
+    }
+  }
+
+ public:
+  path() = default;
+  explicit path(std::string const& pointer) { parse(pointer); }
+  explicit path(char const* pointer) { parse(pointer); }
+
+  // Appends an index
+  path& operator[](size_t value) & {
+    steps_.push_back(step{key_type(), value, false, true});
+    return *this;
+  }
+
+  path&& operator[](size_t value) && { return std::move((*this)[value]); }
+
+  // Appends a key
+  template <class T, class Enabler = std::enable_if_t<!std::is_integral<std::decay_t<T>>(), void>>
+  path& operator[](T&& value) & {
+    steps_.push_back(step{key_type(std::forward<T>(value)), 0u, true, false});
+    return *this;
+  }
+
+  template <class T, class Enabler = std::enable_if_t<!std::is_integral<std::decay_t<T>>(), void>>
+  path&& operator[](T&& value) && {
+    return std::move((*this)[std::forward<T>(value)]);
+  }
+
+  std::size_t size() const noexcept { return steps_.size(); }
+  bool empty() const noexcept { return steps_.empty(); }
+
+  template <class Converter = base_converter>
+  view<Container, Converter> resolve(Container const& root) const {
+    Container const* current = &root;
+    key_type const* key = nullptr;
+    for (step const& current_step : steps_) {
+      if (current->template is<object_type>()) {
+        if (!current_step.has_key) return {};
+        object_type const& object = current->template raw<object_type>();
+        auto it = object.find(current_step.key);
+        if (it == object.end()) return {};
+        key = &it->first;
+        current = &it->second;
+      } else if (current->template is<array_type>()) {
+        array_type const& array = current->template raw<array_type>();
+        if (!current_step.has_index || array.size() <= current_step.index) return {};
+        key = nullptr;
+        current = &array[current_step.index];
+      } else {
+        return {};
+      }
+    }
+    if (key) return {key, *current};
+    return {*current};
+  }
+
+  template <class Converter>
+  view<Container, Converter> resolve(view<Container, Converter> const& root) const {
+    if (root.empty()) return {};
+    if (steps_.empty()) return root;
+    return resolve<Converter>(*root.get_container());
+  }
+
+  view<Container> operator()(Container const& root) const { return resolve(root); }
+
+  template <class Converter>
+  view<Container, Converter> operator()(view<Container, Converter> const& root) const {
+    return resolve(root);
+  }
+};
+}  // namespace json_backbone
+
+#endif  // JSON_BACKBONE_PATH_HEADER
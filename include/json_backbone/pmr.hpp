@@ -0,0 +1,44 @@
+#ifndef JSON_BACKBONE_PMR_HEADER
+#define JSON_BACKBONE_PMR_HEADER
+#include <json_backbone.hpp>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace json_backbone {
+//
+// pmr gathers collections allocating from a memory_resource
+//
+// Collections and heap values use the default resource of the calling thread
+// at the time they are created. Use default_resource_guard, or the make_object
+// and make_array overloads taking a resource, to build a document on a resource.
+//
+namespace pmr {
+template <class Key, class Value>
+using map = std::map<Key, Value, std::less<Key>, polymorphic_allocator<std::pair<Key const, Value>>>;
+
+template <class Value>
+using vector = std::vector<Value, polymorphic_allocator<Value>>;
+
+using string = std::basic_string<char, std::char_traits<char>, polymorphic_allocator<char>>;
+
+// Traits allocating heap values from the default resource
+//
+// Specialize json_backbone::variant_traits for your types and inherit from it:
+//
+// template <class... Others>
+// struct variant_traits<std::nullptr_t, bool, pmr::string, Others...>
+//     : pmr::variant_traits<std::nullptr_t, bool, pmr::string, Others...> {};
+//
+template <class... Value>
+struct variant_traits : default_variant_traits<Value...> {
+  using allocator_type = polymorphic_allocator<char>;
+};
+
+// Container using collections allocating from the default resource
+template <class Key, class... Value>
+using container = json_backbone::container<map, vector, Key, Value...>;
+}  // namespace pmr
+}  // namespace json_backbone
+
+#endif  // JSON_BACKBONE_PMR_HEADER
@@ -0,0 +1,139 @@
+#ifndef JSON_BACKBONE_POOL_HEADER
+#define JSON_BACKBONE_POOL_HEADER
+#include <json_backbone.hpp>
+#include <array>
+#include <cstddef>
+#include <new>
+
+namespace json_backbone {
+// pool_stats gathers the counters of a size_class_pool
+struct pool_stats {
+  std::size_t allocations = 0;    // Blocks handed out
+  std::size_t deallocations = 0;  // Blocks given back
+  std::size_t reuses = 0;         // Allocations served from a free list
+  std::size_t cached_blocks = 0;  // Blocks kept in free lists
+  std::size_t cached_bytes = 0;   // Bytes kept in free lists
+};
+
+//
+// size_class_pool keeps freed blocks in free lists, one per size class
+//
+// Sizes are rounded up to a multiple of granularity, blocks wider than
+// max_size go straight to the global allocator. Blocks are obtained from
+// the global allocator one by one so that any thread may release them,
+// a block freed by another thread simply joins the free lists of that
+// thread. trim gives every cached block back to the global allocator.
+// Pooled values must not outlive the thread, static objects included.
+//
+class size_class_pool {
+ public:
+  static constexpr std::size_t granularity = alignof(std::max_align_t);
+  static constexpr std::size_t max_size = 256u;
+  static constexpr std::size_t class_count = max_size / granularity;
+
+ private:
+  struct free_block {
+    free_block* next;
+  };
+
+  std::array<free_block*, class_count> free_lists_{};
+  pool_stats stats_;
+
+  static constexpr std::size_t class_of(std::size_t bytes) noexcept {
+    return bytes ? (bytes - 1u) / granularity : 0u;
+  }
+
+ public:
+  size_class_pool() = default;
+  size_class_pool(size_class_pool const&) = delete;
+  size_class_pool& operator=(size_class_pool const&) = delete;
+  ~size_class_pool() { trim(); }
+
+  // Returns the pool of the calling thread
+  static size_class_pool& local() noexcept {
+    static thread_local size_class_pool pool;
+    return pool;
+  }
+
+  void* allocate(std::size_t bytes) {
+    ++stats_.allocations;
+    if (max_size < bytes) return ::operator new(bytes);
+    std::size_t const size_class = class_of(bytes);
+    if (free_block* block = free_lists_[size_class]) {
+      free_lists_[size_class] = block->next;
+      ++stats_.reuses;
+      --stats_.cached_blocks;
+      stats_.cached_bytes -= (size_class + 1u) * granularity;
+      return block;
+    }
+    return ::operator new((size_class + 1u) * granularity);
+  }
+
+  void deallocate(void* pointer, std::size_t bytes) noexcept {
+    ++stats_.deallocations;
+    if (max_size < bytes) return ::operator delete(pointer);
+    std::size_t const size_class = class_of(bytes);
+    free_lists_[size_class] = new (pointer) free_block{free_lists_[size_class]};
+    ++stats_.cached_blocks;
+    stats_.cached_bytes += (size_class + 1u) * granularity;
+  }
+
+  // Gives cached blocks back to the global allocator
+  void trim() noexcept {
+    for (free_block*& head : free_lists_) {
+      while (head) {
+        free_block* next = head->next;
+        ::operator delete(head);
+        head = next;
+      }
+    }
+    stats_.cached_blocks = 0;
+    stats_.cached_bytes = 0;
+  }
+
+  pool_stats const& stats() const noexcept { return stats_; }
+};
+
+//
+// pool_allocator allocates from the size_class_pool of the calling thread
+//
+// Use it as the allocator_type of variant_traits to pool heap values:
+//
+// template <class... Others>
+// struct variant_traits<std::nullptr_t, bool, std::string, Others...>
+//     : default_variant_traits<std::nullptr_t, bool, std::string, Others...> {
+//   using allocator_type = pool_allocator<char>;
+// };
+//
+template <class T>
+class pool_allocator {
+  static_assert(alignof(T) <= alignof(std::max_align_t), "Over aligned types are not supported.");
+
+ public:
+  using value_type = T;
+
+  pool_allocator() noexcept = default;
+  template <class U>
+  pool_allocator(pool_allocator<U> const&) noexcept {}
+
+  T* allocate(std::size_t size) {
+    return static_cast<T*>(size_class_pool::local().allocate(size * sizeof(T)));
+  }
+
+  void deallocate(T* pointer, std::size_t size) noexcept {
+    size_class_pool::local().deallocate(pointer, size * sizeof(T));
+  }
+};
+
+template <class T, class U>
+inline bool operator==(pool_allocator<T> const&, pool_allocator<U> const&) noexcept {
+  return true;
+}
+
+template <class T, class U>
+inline bool operator!=(pool_allocator<T> const&, pool_allocator<U> const&) noexcept {
+  return false;
+}
+}  // namespace json_backbone
+
+#endif  // JSON_BACKBONE_POOL_HEADER
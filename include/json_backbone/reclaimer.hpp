@@ -0,0 +1,257 @@
+#ifndef JSON_BACKBONE_RECLAIMER_HEADER
+#define JSON_BACKBONE_RECLAIMER_HEADER
+#include <json_backbone.hpp>
+#include <json_backbone/pool.hpp>
+#include <condition_variable>
+#include <cstddef>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace json_backbone {
+// reclaimer_stats gathers the counters of a reclaimer
+struct reclaimer_stats {
+  std::size_t pending_documents = 0;    // Documents retired and not destroyed yet
+  std::size_t pending_nodes = 0;        // Nodes of the pending documents
+  std::size_t pending_bytes = 0;        // Estimated bytes of the pending documents
+  std::size_t reclaimed_documents = 0;  // Documents destroyed by the reclaimer thread
+  std::size_t reclaimed_nodes = 0;      // Nodes of the reclaimed documents
+  std::size_t reclaimed_bytes = 0;      // Estimated bytes of the reclaimed documents
+  std::size_t inline_documents = 0;     // Documents destroyed by retire, the queue being full
+};
+
+// footprint is the size of the part of a document its owner would free
+struct footprint {
+  std::size_t nodes = 0;  // Containers
+  std::size_t bytes = 0;  // Estimated bytes, containers included
+};
+
+namespace reclaimer_helpers {
+using helpers::rank;
+
+// Bytes a value owns outside of itself, strings may use a small buffer
+template <class Char, class Traits, class Allocator>
+std::size_t owned_bytes(std::basic_string<Char, Traits, Allocator> const& value,
+                        rank<3u>) noexcept {
+  char const* const begin = reinterpret_cast<char const*>(&value);
+  char const* const data = reinterpret_cast<char const*>(value.data());
+  if (begin <= data && data < begin + sizeof(value)) return 0u;
+  return (value.capacity() + 1u) * sizeof(Char);
+}
+
+template <class T>
+auto owned_bytes(T const& array, rank<2u>) noexcept
+    -> decltype(array.capacity(), std::size_t{}) {
+  return array.capacity() * sizeof(typename T::value_type);
+}
+
+template <class T, class Mapped = typename T::mapped_type>
+std::size_t owned_bytes(T const& object, rank<1u>) noexcept {
+  return object.size() * sizeof(typename T::value_type);
+}
+
+template <class T>
+std::size_t owned_bytes(T const&, rank<0u>) noexcept {
+  return 0u;
+}
+
+// Bytes of a bounded value besides its container
+template <class Container>
+struct value_bytes {
+  template <class T>
+  std::size_t operator()(T const& value) const noexcept {
+    return (Container::storage_type::template is_inline<T>::value ? 0u : sizeof(T)) +
+           owned_bytes(value, rank<3u>{});
+  }
+};
+}  // namespace reclaimer_helpers
+
+//
+// Measures the part of value that destroying it would free
+//
+// Collections shared by copy on write are left to their other owners, they
+// are counted as a single node. Byte counts are estimates, they ignore the
+// bookkeeping of allocators and node based collections.
+//
+// The walk stops as soon as the footprint exceeds limit, its cost is bounded
+// by limit.nodes. The footprint returned then exceeds limit but is partial.
+//
+template <class Container>
+footprint measure_footprint(Container& value, footprint const& limit) {
+  using array_type = typename Container::array_type;
+  using object_type = typename Container::object_type;
+  footprint result;
+  std::vector<Container*> stack{&value};
+  while (!stack.empty()) {
+    Container& node = *stack.back();
+    stack.pop_back();
+    ++result.nodes;
+    result.bytes += sizeof(Container);
+    array_type* array = node.template get_if_unique<array_type>();
+    object_type* object = array ? nullptr : node.template get_if_unique<object_type>();
+    if (!array && !object && (node.template is<array_type>() || node.template is<object_type>()))
+      continue;
+    result.bytes += apply_visitor<std::size_t>(static_cast<Container const&>(node),
+                                               reclaimer_helpers::value_bytes<Container>{});
+    std::size_t const elements = array ? array->size() : object ? object->size() : 0u;
+    if (limit.nodes < result.nodes + stack.size() + elements || limit.bytes < result.bytes) {
+      result.nodes += stack.size() + elements;
+      return result;
+    }
+    if (array)
+      for (auto& element : *array) stack.push_back(&element);
+    else if (object)
+      for (auto& element : *object) stack.push_back(&element.second);
+  }
+  return result;
+}
+
+template <class Container>
+footprint measure_footprint(Container& value) {
+  std::size_t const unbounded = std::numeric_limits<std::size_t>::max();
+  return measure_footprint(value, footprint{unbounded, unbounded});
+}
+
+//
+// reclaimer destroys retired documents on a background thread
+//
+// retire hands a document over, the reclaimer thread destroys retired
+// documents by batches. Pending documents are bounded by a number of nodes
+// and of bytes, a document which would exceed them is destroyed by retire
+// itself. retire measures documents against the room left under the bounds,
+// its walk stops once they are exceeded and never visits more than max_nodes
+// nodes, however large the document. Scalars are never worth a hand over and
+// are destroyed in place. Destroying the reclaimer waits for pending documents.
+//
+// Blocks of a pool_allocator freed by the reclaimer thread would join the
+// free lists of that thread, which their owner neither reuses nor trims. The
+// reclaimer thread trims its pool after each batch instead, giving them back
+// to the global allocator.
+//
+template <class Container>
+class reclaimer {
+ public:
+  using container_type = Container;
+
+ private:
+  struct retired {
+    Container value;
+    footprint size;
+  };
+
+  std::size_t const max_nodes_;
+  std::size_t const max_bytes_;
+  mutable std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable idle_;
+  std::vector<retired> queue_;
+  reclaimer_stats stats_;
+  bool busy_ = false;
+  bool stopping_ = false;
+  std::thread thread_;
+
+  void run() {
+    std::vector<retired> batch;
+    std::unique_lock<std::mutex> lock{mutex_};
+    for (;;) {
+      wake_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+      if (queue_.empty()) return;
+      batch.swap(queue_);
+      busy_ = true;
+      lock.unlock();
+
+      footprint reclaimed;
+      std::size_t const documents = batch.size();
+      for (retired const& document : batch) {
+        reclaimed.nodes += document.size.nodes;
+        reclaimed.bytes += document.size.bytes;
+      }
+      batch.clear();
+      size_class_pool::local().trim();
+
+      lock.lock();
+      busy_ = false;
+      stats_.pending_documents -= documents;
+      stats_.pending_nodes -= reclaimed.nodes;
+      stats_.pending_bytes -= reclaimed.bytes;
+      stats_.reclaimed_documents += documents;
+      stats_.reclaimed_nodes += reclaimed.nodes;
+      stats_.reclaimed_bytes += reclaimed.bytes;
+      idle_.notify_all();
+    }
+  }
+
+ public:
+  explicit reclaimer(std::size_t max_nodes = 1u << 24u, std::size_t max_bytes = 1u << 30u)
+      : max_nodes_{max_nodes}, max_bytes_{max_bytes}, thread_{&reclaimer::run, this} {}
+  reclaimer(reclaimer const&) = delete;
+  reclaimer& operator=(reclaimer const&) = delete;
+  ~reclaimer() {
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      stopping_ = true;
+    }
+    wake_.notify_one();
+    thread_.join();
+  }
+
+  // Returns the reclaimer used by the free function retire
+  static reclaimer& global() {
+    static reclaimer instance;
+    return instance;
+  }
+
+  // Hands value over to the reclaimer thread, returns false if it was destroyed in place
+  bool retire(Container&& value) {
+    using array_type = typename Container::array_type;
+    using object_type = typename Container::object_type;
+    Container document{std::move(value)};
+    if (!document.template is<array_type>() && !document.template is<object_type>()) return false;
+    footprint room;
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      room.nodes = max_nodes_ - stats_.pending_nodes;
+      room.bytes = max_bytes_ - stats_.pending_bytes;
+    }
+    footprint const size = measure_footprint(document, room);
+    {
+      std::lock_guard<std::mutex> lock{mutex_};
+      if (stats_.pending_nodes + size.nodes <= max_nodes_ &&
+          stats_.pending_bytes + size.bytes <= max_bytes_) {
+        queue_.push_back(retired{std::move(document), size});
+        ++stats_.pending_documents;
+        stats_.pending_nodes += size.nodes;
+        stats_.pending_bytes += size.bytes;
+        wake_.notify_one();
+        return true;
+      }
+      ++stats_.inline_documents;
+    }
+    return false;
+  }
+
+  // Waits until every document retired so far is destroyed
+  void drain() {
+    std::unique_lock<std::mutex> lock{mutex_};
+    idle_.wait(lock, [this] { return queue_.empty() && !busy_; });
+  }
+
+  reclaimer_stats stats() const {
+    std::lock_guard<std::mutex> lock{mutex_};
+    return stats_;
+  }
+};
+
+// Hands value over to the global reclaimer of its type
+template <class Container>
+bool retire(Container&& value) {
+  static_assert(!std::is_lvalue_reference<Container>::value, "Only rvalues can be retired.");
+  return reclaimer<Container>::global().retire(std::move(value));
+}
+}  // namespace json_backbone
+
+#endif  // JSON_BACKBONE_RECLAIMER_HEADER
@@ -0,0 +1,610 @@
+#ifndef JSON_BACKBONE_SERIALIZER_HEADER
+#define JSON_BACKBONE_SERIALIZER_HEADER
+#include <json_backbone.hpp>
+#include <json_backbone/text.hpp>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace json_backbone {
+// string_sink appends serialized texts to a string
+class string_sink {
+  std::string& output_;
+
+ public:
+  explicit string_sink(std::string& output) noexcept : output_(output) {}
+  void write(char const* data, std::size_t size) { output_.append(data, size); }
+};
+
+namespace serializer_helpers {
+using helpers::rank;
+
+// Writes the decimal digits of value ending at last, returns the first one
+template <class Unsigned>
+char* write_digits(Unsigned value, char* last) noexcept {
+  static constexpr char pairs[] =
+      "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+      "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+      "8081828384858687888990919293949596979899";
+  while (100u <= value) {
+    Unsigned const pair = value % 100u;
+    value /= 100u;
+    *--last = pairs[2u * pair + 1u];
+    *--last = pairs[2u * pair];
+  }
+  if (10u <= value) {
+    *--last = pairs[2u * value + 1u];
+    *--last = pairs[2u * value];
+  } else {
+    *--last = static_cast<char>('0' + value);
+  }
+  return last;
+}
+
+//
+// Grisu2 conversion of doubles to the digits of their shortest representation
+//
+// Finds a short digit string within the rounding interval of a double with
+// 64 bits integer arithmetic only, using cached powers of ten. The digits always
+// read back as the same double, and are the shortest ones but for a tiny
+// fraction of values, where one more digit is written. See "Printing
+// Floating-Point Numbers Quickly and Accurately with Integers", Loitsch, 2010.
+//
+struct diy_fp {
+  std::uint64_t f;
+  int e;
+};
+
+inline diy_fp subtract(diy_fp lhs, diy_fp rhs) noexcept { return {lhs.f - rhs.f, lhs.e}; }
+
+// Returns the 64 upper bits of the product, rounded
+inline diy_fp multiply(diy_fp lhs, diy_fp rhs) noexcept {
+  std::uint64_t const mask = 0xFFFFFFFFu;
+  std::uint64_t const lhs_low = lhs.f & mask, lhs_high = lhs.f >> 32u;
+  std::uint64_t const rhs_low = rhs.f & mask, rhs_high = rhs.f >> 32u;
+  std::uint64_t const low_low = lhs_low * rhs_low, low_high = lhs_low * rhs_high;
+  std::uint64_t const high_low = lhs_high * rhs_low, high_high = lhs_high * rhs_high;
+  std::uint64_t const middle = (low_low >> 32u) + (low_high & mask) + (high_low & mask) +
+                               (std::uint64_t{1} << 31u);
+  return {high_high + (high_low >> 32u) + (low_high >> 32u) + (middle >> 32u),
+          lhs.e + rhs.e + 64};
+}
+
+inline diy_fp normalize(diy_fp value) noexcept {
+#if defined(__GNUC__)
+  int const shift = __builtin_clzll(value.f);
+  return {value.f << shift, value.e - shift};
+#else
+  while (!(value.f >> 63u)) {
+    value.f <<= 1u;
+    --value.e;
+  }
+  return value;
+#endif
+}
+
+// Digits and decimal exponent of value, such that value = digits * 10^exponent
+struct decimal {
+  char digits[20];
+  int size;
+  int exponent;
+};
+
+struct cached_power {
+  std::uint64_t f;
+  int e;
+  int k;
+};
+
+// Returns c = 10^k such that the product of c and 2^exponent has a binary exponent in [-60, -32]
+inline cached_power power_for_binary_exponent(int exponent) noexcept {
+  static constexpr cached_power powers[] = {
+      {0xAB70FE17C79AC6CAull, -1060, -300},
+      {0xFF77B1FCBEBCDC4Full, -1034, -292},
+      {0xBE5691EF416BD60Cull, -1007, -284},
+      {0x8DD01FAD907FFC3Cull, -980, -276},
+      {0xD3515C2831559A83ull, -954, -268},
+      {0x9D71AC8FADA6C9B5ull, -927, -260},
+      {0xEA9C227723EE8BCBull, -901, -252},
+      {0xAECC49914078536Dull, -874, -244},
+      {0x823C12795DB6CE57ull, -847, -236},
+      {0xC21094364DFB5637ull, -821, -228},
+      {0x9096EA6F3848984Full, -794, -220},
+      {0xD77485CB25823AC7ull, -768, -212},
+      {0xA086CFCD97BF97F4ull, -741, -204},
+      {0xEF340A98172AACE5ull, -715, -196},
+      {0xB23867FB2A35B28Eull, -688, -188},
+      {0x84C8D4DFD2C63F3Bull, -661, -180},
+      {0xC5DD44271AD3CDBAull, -635, -172},
+      {0x936B9FCEBB25C996ull, -608, -164},
+      {0xDBAC6C247D62A584ull, -582, -156},
+      {0xA3AB66580D5FDAF6ull, -555, -148},
+      {0xF3E2F893DEC3F126ull, -529, -140},
+      {0xB5B5ADA8AAFF80B8ull, -502, -132},
+      {0x87625F056C7C4A8Bull, -475, -124},
+      {0xC9BCFF6034C13053ull, -449, -116},
+      {0x964E858C91BA2655ull, -422, -108},
+      {0xDFF9772470297EBDull, -396, -100},
+      {0xA6DFBD9FB8E5B88Full, -369, -92},
+      {0xF8A95FCF88747D94ull, -343, -84},
+      {0xB94470938FA89BCFull, -316, -76},
+      {0x8A08F0F8BF0F156Bull, -289, -68},
+      {0xCDB02555653131B6ull, -263, -60},
+      {0x993FE2C6D07B7FACull, -236, -52},
+      {0xE45C10C42A2B3B06ull, -210, -44},
+      {0xAA242499697392D3ull, -183, -36},
+      {0xFD87B5F28300CA0Eull, -157, -28},
+      {0xBCE5086492111AEBull, -130, -20},
+      {0x8CBCCC096F5088CCull, -103, -12},
+      {0xD1B71758E219652Cull, -77, -4},
+      {0x9C40000000000000ull, -50, 4},
+      {0xE8D4A51000000000ull, -24, 12},
+      {0xAD78EBC5AC620000ull, 3, 20},
+      {0x813F3978F8940984ull, 30, 28},
+      {0xC097CE7BC90715B3ull, 56, 36},
+      {0x8F7E32CE7BEA5C70ull, 83, 44},
+      {0xD5D238A4ABE98068ull, 109, 52},
+      {0x9F4F2726179A2245ull, 136, 60},
+      {0xED63A231D4C4FB27ull, 162, 68},
+      {0xB0DE65388CC8ADA8ull, 189, 76},
+      {0x83C7088E1AAB65DBull, 216, 84},
+      {0xC45D1DF942711D9Aull, 242, 92},
+      {0x924D692CA61BE758ull, 269, 100},
+      {0xDA01EE641A708DEAull, 295, 108},
+      {0xA26DA3999AEF774Aull, 322, 116},
+      {0xF209787BB47D6B85ull, 348, 124},
+      {0xB454E4A179DD1877ull, 375, 132},
+      {0x865B86925B9BC5C2ull, 402, 140},
+      {0xC83553C5C8965D3Dull, 428, 148},
+      {0x952AB45CFA97A0B3ull, 455, 156},
+      {0xDE469FBD99A05FE3ull, 481, 164},
+      {0xA59BC234DB398C25ull, 508, 172},
+      {0xF6C69A72A3989F5Cull, 534, 180},
+      {0xB7DCBF5354E9BECEull, 561, 188},
+      {0x88FCF317F22241E2ull, 588, 196},
+      {0xCC20CE9BD35C78A5ull, 614, 204},
+      {0x98165AF37B2153DFull, 641, 212},
+      {0xE2A0B5DC971F303Aull, 667, 220},
+      {0xA8D9D1535CE3B396ull, 694, 228},
+      {0xFB9B7CD9A4A7443Cull, 720, 236},
+      {0xBB764C4CA7A44410ull, 747, 244},
+      {0x8BAB8EEFB6409C1Aull, 774, 252},
+      {0xD01FEF10A657842Cull, 800, 260},
+      {0x9B10A4E5E9913129ull, 827, 268},
+      {0xE7109BFBA19C0C9Dull, 853, 276},
+      {0xAC2820D9623BF429ull, 880, 284},
+      {0x80444B5E7AA7CF85ull, 907, 292},
+      {0xBF21E44003ACDD2Dull, 933, 300},
+      {0x8E679C2F5E44FF8Full, 960, 308},
+      {0xD433179D9C8CB841ull, 986, 316},
+      {0x9E19DB92B4E31BA9ull, 1013, 324},
+  };
+  int const f = -60 - exponent - 1;
+  int const k = (f * 78913) / (1 << 18) + static_cast<int>(0 < f);
+  return powers[(300 + k + 7) / 8];
+}
+
+// Moves the last digit towards w while it stays within the interval
+inline void round_last_digit(decimal& output, std::uint64_t distance, std::uint64_t delta,
+                             std::uint64_t rest, std::uint64_t ten_k) noexcept {
+  while (rest < distance && ten_k <= delta - rest &&
+         (rest + ten_k < distance || rest + ten_k - distance < distance - rest)) {
+    --output.digits[output.size - 1];
+    rest += ten_k;
+  }
+}
+
+// Generates the digits of the shortest number in [low, high], the closest to w
+inline void generate_digits(decimal& output, diy_fp low, diy_fp w, diy_fp high) noexcept {
+  std::uint64_t delta = subtract(high, low).f;
+  std::uint64_t distance = subtract(high, w).f;
+  diy_fp const one{std::uint64_t{1} << -high.e, high.e};
+  auto integral = static_cast<std::uint32_t>(high.f >> -one.e);
+  std::uint64_t fractional = high.f & (one.f - 1u);
+
+  std::uint32_t power = 1000000000u;
+  int remaining = 10;
+  while (integral < power && 1 < remaining) {
+    power /= 10u;
+    --remaining;
+  }
+  while (0 < remaining) {
+    output.digits[output.size++] = static_cast<char>('0' + integral / power);
+    integral %= power;
+    --remaining;
+    std::uint64_t const rest = (std::uint64_t{integral} << -one.e) + fractional;
+    if (rest <= delta) {
+      output.exponent += remaining;
+      round_last_digit(output, distance, delta, rest, std::uint64_t{power} << -one.e);
+      return;
+    }
+    power /= 10u;
+  }
+  for (;;) {
+    fractional *= 10u;
+    output.digits[output.size++] = static_cast<char>('0' + (fractional >> -one.e));
+    fractional &= one.f - 1u;
+    delta *= 10u;
+    distance *= 10u;
+    --output.exponent;
+    if (fractional <= delta) break;
+  }
+  round_last_digit(output, distance, delta, fractional, one.f);
+}
+
+// Returns the shortest digits of a finite and positive double
+inline decimal shortest_digits(double value) noexcept {
+  std::uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  std::uint64_t const hidden_bit = std::uint64_t{1} << 52u;
+  std::uint64_t const significand = bits & (hidden_bit - 1u);
+  int const biased_exponent = static_cast<int>(bits >> 52u);
+  diy_fp const v = biased_exponent ? diy_fp{significand + hidden_bit, biased_exponent - 1075}
+                                   : diy_fp{significand, -1074};
+
+  // Boundaries of the rounding interval, closer below powers of two
+  diy_fp const high = normalize({2u * v.f + 1u, v.e - 1});
+  diy_fp low = (0u == significand && 1 < biased_exponent) ? diy_fp{4u * v.f - 1u, v.e - 2}
+                                                          : diy_fp{2u * v.f - 1u, v.e - 1};
+  low = {low.f << (low.e - high.e), high.e};
+
+  cached_power const power = power_for_binary_exponent(high.e);
+  diy_fp const scale{power.f, power.e};
+  diy_fp const w = multiply(normalize(v), scale);
+  diy_fp const scaled_low = multiply(low, scale);
+  diy_fp const scaled_high = multiply(high, scale);
+
+  decimal output;
+  output.size = 0;
+  output.exponent = -power.k;
+  generate_digits(output, {scaled_low.f + 1u, scaled_low.e}, w,
+                  {scaled_high.f - 1u, scaled_high.e});
+  return output;
+}
+
+//
+// Writes the shortest text read back as value, returns its end
+//
+// Numbers whose decimal point is in the 21 first digits are written without
+// exponent. Integral values keep a fraction so that they are read back as
+// floating point numbers. Not a number and infinities have no JSON
+// representation and are written as null. Output must hold 32 characters.
+//
+inline char* write_double(double value, char* output) noexcept {
+  if (!std::isfinite(value)) {
+    std::memcpy(output, "null", 4u);
+    return output + 4u;
+  }
+  if (std::signbit(value)) {
+    *output++ = '-';
+    value = -value;
+  }
+  if (0. == value) {
+    std::memcpy(output, "0.0", 3u);
+    return output + 3u;
+  }
+
+  decimal const number = shortest_digits(value);
+  int const size = number.size;
+  int const point = size + number.exponent;  // Position of the decimal point in the digits
+  if (size <= point && point <= 21) {
+    std::memcpy(output, number.digits, static_cast<std::size_t>(size));
+    std::memset(output + size, '0', static_cast<std::size_t>(point - size));
+    output += point;
+    std::memcpy(output, ".0", 2u);
+    return output + 2u;
+  }
+  if (0 < point && point <= 21) {
+    std::memcpy(output, number.digits, static_cast<std::size_t>(point));
+    output[point] = '.';
+    std::memcpy(output + point + 1, number.digits + point, static_cast<std::size_t>(size - point));
+    return output + size + 1;
+  }
+  if (-6 < point && point <= 0) {
+    std::memcpy(output, "0.", 2u);
+    std::memset(output + 2, '0', static_cast<std::size_t>(-point));
+    output += 2 - point;
+    std::memcpy(output, number.digits, static_cast<std::size_t>(size));
+    return output + size;
+  }
+
+  // Scientific notation, d[.ddd]e[+-]x
+  *output++ = number.digits[0];
+  if (1 < size) {
+    *output++ = '.';
+    std::memcpy(output, number.digits + 1, static_cast<std::size_t>(size - 1));
+    output += size - 1;
+  }
+  int exponent = point - 1;
+  *output++ = 'e';
+  *output++ = exponent < 0 ? '-' : '+';
+  if (exponent < 0) exponent = -exponent;
+  char digits[4];
+  char* const last = digits + sizeof(digits);
+  char* const first = write_digits(static_cast<unsigned>(exponent), last);
+  std::memcpy(output, first, static_cast<std::size_t>(last - first));
+  return output + (last - first);
+}
+}  // namespace serializer_helpers
+
+//
+// serializer writes containers as JSON texts (RFC 8259) to a sink
+//
+// A sink is any object with a write(char const*, std::size_t) member, such as
+// string_sink or std::ostream. Text is gathered in a fixed buffer handed to
+// the sink as it fills up. Nesting is tracked with explicit stacks rather
+// than by recursion, and strings are scanned 16 characters at a time with
+// SSE2 when available for the characters to escape. Other characters are
+// written as is, strings are expected to be valid UTF-8.
+//
+// A non null indent pretty prints the text: each element goes on its own line,
+// indented by as many spaces per nesting level. Keys and strings are written
+// from types exposing char data() and size(), or c_str() and size(), other
+// types from their output stream operator.
+//
+template <class Container, class Sink>
+class serializer {
+ public:
+  using container_type = Container;
+  using array_type = typename Container::array_type;
+  using object_type = typename Container::object_type;
+  static constexpr std::size_t buffer_size = 4096u;
+
+ private:
+  enum class frame : char { array, object };
+
+  template <class Collection>
+  struct position {
+    typename Collection::const_iterator current;
+    typename Collection::const_iterator end;
+    bool first;
+  };
+
+  Sink& sink_;
+  std::size_t indent_;
+  std::size_t size_ = 0u;
+  char buffer_[buffer_size];
+  std::vector<frame> frames_;
+  std::vector<position<array_type>> arrays_;
+  std::vector<position<object_type>> objects_;
+
+  void flush() {
+    if (size_) sink_.write(buffer_, size_);
+    size_ = 0u;
+  }
+
+  // Returns room for size characters in the buffer
+  char* reserve(std::size_t size) {
+    if (buffer_size - size_ < size) flush();
+    return buffer_ + size_;
+  }
+
+  void put(char value) {
+    if (buffer_size == size_) flush();
+    buffer_[size_++] = value;
+  }
+
+  void append(char const* data, std::size_t size) {
+    if (buffer_size - size_ < size) {
+      flush();
+      if (buffer_size < size) {
+        sink_.write(data, size);
+        return;
+      }
+    }
+    std::memcpy(buffer_ + size_, data, size);
+    size_ += size;
+  }
+
+  void new_line(std::size_t depth) {
+    if (!indent_) return;
+    put('\n');
+    for (std::size_t spaces = depth * indent_; spaces;) {
+      std::size_t const size = spaces < buffer_size ? spaces : buffer_size;
+      std::memset(reserve(size), ' ', size);
+      size_ += size;
+      spaces -= size;
+    }
+  }
+
+  void write_escaped(char value) {
+    static constexpr char hex[] = "0123456789abcdef";
+    char* output = reserve(6u);
+    switch (value) {
+      case '"':
+      case '\\':
+        output[1] = value;
+        break;
+      case '\b':
+        output[1] = 'b';
+        break;
+      case '\f':
+        output[1] = 'f';
+        break;
+      case '\n':
+        output[1] = 'n';
+        break;
+      case '\r':
+        output[1] = 'r';
+        break;
+      case '\t':
+        output[1] = 't';
+        break;
+      default:
+        std::memcpy(output, "\\u00", 4u);
+        output[4] = hex[static_cast<unsigned char>(value) >> 4u];
+        output[5] = hex[static_cast<unsigned char>(value) & 0xFu];
+        size_ += 6u;
+        return;
+    }
+    output[0] = '\\';
+    size_ += 2u;
+  }
+
+  void write_string(char const* data, std::size_t size) {
+    char const* const last = data + size;
+    put('"');
+    while (data != last) {
+      char const* const special = text_helpers::skip_string_plain(data, last);
+      append(data, static_cast<std::size_t>(special - data));
+      if (special == last) break;
+      write_escaped(*special);
+      data = special + 1;
+    }
+    put('"');
+  }
+
+  template <class T>
+  auto write_text(T const& value, serializer_helpers::rank<2u>)
+      -> std::enable_if_t<std::is_same<std::decay_t<decltype(*value.data())>, char>::value &&
+                          std::is_integral<decltype(value.size())>::value> {
+    write_string(value.data(), value.size());
+  }
+
+  template <class T>
+  auto write_text(T const& value, serializer_helpers::rank<1u>)
+      -> decltype(value.c_str(), value.size(), void()) {
+    write_string(value.c_str(), value.size());
+  }
+
+  template <class T>
+  void write_text(T const& value, serializer_helpers::rank<0u>) {
+    std::ostringstream stream;
+    stream << value;
+    std::string const text = stream.str();
+    write_string(text.data(), text.size());
+  }
+
+  // Writes scalar values, collections are opened by write_value
+  struct scalar_writer {
+    serializer& self;
+
+    void operator()(std::nullptr_t) const { self.append("null", 4u); }
+
+    void operator()(bool value) const {
+      value ? self.append("true", 4u) : self.append("false", 5u);
+    }
+
+    void operator()(array_type const&) const {}
+    void operator()(object_type const&) const {}
+
+    template <class T>
+    std::enable_if_t<std::is_integral<T>::value> operator()(T value) const {
+      using unsigned_type = std::make_unsigned_t<T>;
+      char* const output = self.reserve(24u);
+      char digits[24];
+      char* const last = digits + sizeof(digits);
+      bool const negative = value < T{};
+      unsigned_type const magnitude =
+          negative ? static_cast<unsigned_type>(0u - static_cast<unsigned_type>(value))
+                   : static_cast<unsigned_type>(value);
+      char* first = serializer_helpers::write_digits(magnitude, last);
+      if (negative) *--first = '-';
+      std::size_t const size = static_cast<std::size_t>(last - first);
+      std::memcpy(output, first, size);
+      self.size_ += size;
+    }
+
+    template <class T>
+    std::enable_if_t<std::is_floating_point<T>::value> operator()(T value) const {
+      char* const output = self.reserve(32u);
+      self.size_ += static_cast<std::size_t>(
+          serializer_helpers::write_double(static_cast<double>(value), output) - output);
+    }
+
+    template <class T>
+    std::enable_if_t<!std::is_arithmetic<T>::value> operator()(T const& value) const {
+      self.write_text(value, serializer_helpers::rank<2u>{});
+    }
+  };
+
+  // Writes a scalar, or opens a collection which the caller then walks
+  void write_value(Container const& value) {
+    if (value.template is<array_type>()) {
+      array_type const& array = value.template get<array_type>();
+      if (array.empty()) return append("[]", 2u);
+      put('[');
+      frames_.push_back(frame::array);
+      arrays_.push_back({array.begin(), array.end(), true});
+    } else if (value.template is<object_type>()) {
+      object_type const& object = value.template get<object_type>();
+      if (object.empty()) return append("{}", 2u);
+      put('{');
+      frames_.push_back(frame::object);
+      objects_.push_back({object.begin(), object.end(), true});
+    } else {
+      apply_visitor<void>(value, scalar_writer{*this});
+    }
+  }
+
+ public:
+  explicit serializer(Sink& sink, std::size_t indent = 0u) : sink_(sink), indent_{indent} {}
+  serializer(serializer const&) = delete;
+  serializer& operator=(serializer const&) = delete;
+
+  // Writes a whole document then hands the remaining text to the sink
+  void write(Container const& value) {
+    frames_.clear();
+    arrays_.clear();
+    objects_.clear();
+    write_value(value);
+    while (!frames_.empty()) {
+      if (frame::array == frames_.back()) {
+        position<array_type>& array = arrays_.back();
+        if (array.current == array.end) {
+          arrays_.pop_back();
+          frames_.pop_back();
+          new_line(frames_.size());
+          put(']');
+          continue;
+        }
+        if (!array.first) put(',');
+        array.first = false;
+        new_line(frames_.size());
+        write_value(*array.current++);
+      } else {
+        position<object_type>& object = objects_.back();
+        if (object.current == object.end) {
+          objects_.pop_back();
+          frames_.pop_back();
+          new_line(frames_.size());
+          put('}');
+          continue;
+        }
+        if (!object.first) put(',');
+        object.first = false;
+        new_line(frames_.size());
+        auto const& element = *object.current++;
+        write_text(element.first, serializer_helpers::rank<2u>{});
+        indent_ ? append(": ", 2u) : put(':');
+        write_value(element.second);
+      }
+    }
+    flush();
+  }
+};
+
+template <class Container, class Sink>
+constexpr std::size_t serializer<Container, Sink>::buffer_size;
+
+// Writes value as a JSON text to sink, pretty printed if indent is not null
+template <class Container, class Sink>
+void serialize(Container const& value, Sink& sink, std::size_t indent = 0u) {
+  serializer<Container, Sink>{sink, indent}.write(value);
+}
+
+// Returns value as a JSON text, pretty printed if indent is not null
+template <class Container>
+std::string to_json(Container const& value, std::size_t indent = 0u) {
+  std::string output;
+  string_sink sink{output};
+  serialize(value, sink, indent);
+  return output;
+}
+}  // namespace json_backbone
+
+#endif  // JSON_BACKBONE_SERIALIZER_HEADER
@@ -0,0 +1,242 @@
+#ifndef JSON_BACKBONE_SYMBOL_HEADER
+#define JSON_BACKBONE_SYMBOL_HEADER
+#include <json_backbone.hpp>
+#include <json_backbone/transparent.hpp>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace json_backbone {
+class symbol;
+
+namespace helpers {
+// Returns the next id of an interned string, ids grow across every table of the process
+inline std::size_t next_symbol_id() noexcept {
+  static std::atomic<std::size_t> id{1u};
+  return id.fetch_add(1u, std::memory_order_relaxed);
+}
+
+// An interned string and its id
+using symbol_entry = std::pair<std::string const, std::size_t>;
+}  // namespace helpers
+
+//
+// symbol_table stores a single copy of every interned string
+//
+// Interned strings keep their address until the table is destroyed, symbols
+// shall not outlive the table they come from. Interning is thread safe, find
+// only takes a shared lock and never adds a string to the table. Strings are
+// indexed by their characters, neither find nor interning a string already in
+// the table allocates, and the latter only takes the exclusive lock to insert.
+//
+class symbol_table {
+  // Characters of an interned or looked up string
+  struct text {
+    char const* data;
+    std::size_t size;
+
+    friend bool operator==(text lhs, text rhs) noexcept {
+      return lhs.size == rhs.size && 0 == std::memcmp(lhs.data, rhs.data, lhs.size);
+    }
+  };
+
+  struct text_hash {
+    std::size_t operator()(text value) const noexcept {
+      return helpers::hash_bytes(value.data, value.size);
+    }
+  };
+
+  std::deque<helpers::symbol_entry> entries_;  // Interned strings and their ids
+  std::unordered_map<text, helpers::symbol_entry const*, text_hash> index_;
+  mutable std::shared_timed_mutex mutex_;
+
+ public:
+  symbol_table() = default;
+  symbol_table(symbol_table const&) = delete;
+  symbol_table& operator=(symbol_table const&) = delete;
+
+  // Returns the process wide table
+  static symbol_table& global() {
+    static symbol_table table;
+    return table;
+  }
+
+  inline symbol intern(std::string const& text);
+  inline symbol intern(char const* text, std::size_t size);
+
+  // Returns the symbol of an interned string, the null symbol if text was never interned
+  inline symbol find(std::string const& text) const;
+  inline symbol find(char const* text, std::size_t size) const;
+
+  std::size_t size() const {
+    std::shared_lock<std::shared_timed_mutex> lock{mutex_};
+    return index_.size();
+  }
+};
+
+namespace helpers {
+inline symbol_table*& default_symbol_table() noexcept {
+  static thread_local symbol_table* table = &symbol_table::global();
+  return table;
+}
+}  // namespace helpers
+
+// Returns the table used by implicit symbol conversions in the calling thread
+inline symbol_table& get_default_symbol_table() noexcept {
+  return *helpers::default_symbol_table();
+}
+
+// Sets the default symbol table of the calling thread, returns the previous one
+inline symbol_table& set_default_symbol_table(symbol_table& table) noexcept {
+  symbol_table& previous = *helpers::default_symbol_table();
+  helpers::default_symbol_table() = &table;
+  return previous;
+}
+
+// default_symbol_table_guard sets the default symbol table of the calling thread for its lifetime
+class default_symbol_table_guard {
+  symbol_table* previous_;
+
+ public:
+  explicit default_symbol_table_guard(symbol_table& table) noexcept
+      : previous_{&set_default_symbol_table(table)} {}
+  default_symbol_table_guard(default_symbol_table_guard const&) = delete;
+  default_symbol_table_guard(default_symbol_table_guard&& other) noexcept
+      : previous_{other.previous_} {
+    other.previous_ = nullptr;
+  }
+  default_symbol_table_guard& operator=(default_symbol_table_guard const&) = delete;
+  ~default_symbol_table_guard() {
+    if (previous_) set_default_symbol_table(*previous_);
+  }
+};
+
+//
+// symbol is an interned string usable as a container key
+//
+// Symbols are equal when they come from the same interned string. Strings are
+// implicitly interned in the default symbol table, so that container["name"]
+// works, but repeated lookups should intern their keys once:
+//
+// symbol const name{"name"};
+// c[name] = "Roger";
+//
+// Read-only lookups through container::operator[] const and view::operator[]
+// use symbol_table::find instead, so that missing keys are not interned.
+//
+class symbol {
+  friend class symbol_table;
+  using entry = helpers::symbol_entry;
+
+  entry const* entry_;
+
+  static entry const& empty_entry() {
+    static entry const value{std::string{}, 0u};
+    return value;
+  }
+
+  static entry const& null_entry() {
+    static entry const value{std::string{}, ~std::size_t{0}};
+    return value;
+  }
+
+  explicit symbol(entry const* value) noexcept : entry_{value} {}
+
+ public:
+  symbol() noexcept : entry_{&empty_entry()} {}
+  symbol(std::string const& text) : symbol{get_default_symbol_table().intern(text)} {}
+  symbol(char const* text) : symbol{text, std::strlen(text)} {}
+  symbol(char const* text, std::size_t size)
+      : symbol{get_default_symbol_table().intern(text, size)} {}
+  symbol(symbol_table& table, std::string const& text) : symbol{table.intern(text)} {}
+  symbol(symbol const&) noexcept = default;
+  symbol& operator=(symbol const&) noexcept = default;
+
+  // Returns the symbol of strings which are not interned, equal to no other symbol
+  static symbol null() noexcept { return symbol{&null_entry()}; }
+
+  bool is_null() const noexcept { return entry_ == &null_entry(); }
+  std::string const& str() const noexcept { return entry_->first; }
+  char const* c_str() const noexcept { return entry_->first.c_str(); }
+  std::size_t size() const noexcept { return entry_->first.size(); }
+  bool empty() const noexcept { return entry_->first.empty(); }
+
+  friend bool operator==(symbol lhs, symbol rhs) noexcept { return lhs.entry_ == rhs.entry_; }
+  friend bool operator!=(symbol lhs, symbol rhs) noexcept { return lhs.entry_ != rhs.entry_; }
+
+  // Symbols are ordered by interning order, not alphabetically. A std::map of
+  // symbols thus iterates, and serializes, its keys in the order they were first
+  // interned in the process. That order is the same from one run to another as
+  // long as strings are interned in the same order, which concurrent interning
+  // from several threads does not guarantee.
+  friend bool operator<(symbol lhs, symbol rhs) noexcept {
+    return lhs.entry_->second < rhs.entry_->second;
+  }
+
+  friend std::ostream& operator<<(std::ostream& output, symbol value) {
+    return output << value.entry_->first;
+  }
+
+  friend struct std::hash<symbol>;
+};
+
+inline symbol symbol_table::intern(std::string const& text) {
+  return intern(text.data(), text.size());
+}
+
+inline symbol symbol_table::intern(char const* text, std::size_t size) {
+  symbol const found = find(text, size);
+  if (!found.is_null()) return found;
+  std::lock_guard<std::shared_timed_mutex> lock{mutex_};
+  auto it = index_.find({text, size});
+  if (it != index_.end()) return symbol{it->second};
+  entries_.emplace_back(std::string{text, size}, helpers::next_symbol_id());
+  helpers::symbol_entry const& entry = entries_.back();
+  try {
+    index_.emplace(symbol_table::text{entry.first.data(), entry.first.size()}, &entry);
+  } catch (...) {
+    entries_.pop_back();
+    throw;
+  }
+  return symbol{&entry};
+}
+
+inline symbol symbol_table::find(std::string const& text) const {
+  return find(text.data(), text.size());
+}
+
+inline symbol symbol_table::find(char const* text, std::size_t size) const {
+  if (!size) return {};
+  std::shared_lock<std::shared_timed_mutex> lock{mutex_};
+  auto it = index_.find({text, size});
+  return it == index_.end() ? symbol::null() : symbol{it->second};
+}
+
+// Read-only lookups of symbol keys find strings without interning them
+template <>
+struct key_lookup<symbol> {
+  static symbol find(std::string const& text) { return get_default_symbol_table().find(text); }
+  static symbol find(char const* text) {
+    return get_default_symbol_table().find(text, std::strlen(text));
+  }
+};
+}  // namespace json_backbone
+
+namespace std {
+template <>
+struct hash<json_backbone::symbol> {
+  std::size_t operator()(json_backbone::symbol value) const noexcept {
+    return std::hash<void const*>{}(value.entry_);
+  }
+};
+}  // namespace std
+
+#endif  // JSON_BACKBONE_SYMBOL_HEADER
@@ -0,0 +1,90 @@
+#ifndef JSON_BACKBONE_TEXT_HEADER
+#define JSON_BACKBONE_TEXT_HEADER
+#include <cstdint>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && 2 <= _M_IX86_FP)
+#include <emmintrin.h>
+#define JSON_BACKBONE_TEXT_SSE2 1
+#endif
+
+namespace json_backbone {
+// Scanning of JSON texts shared by the parser and the serializer
+namespace text_helpers {
+inline bool is_whitespace(char value) noexcept {
+  return ' ' == value || '\n' == value || '\r' == value || '\t' == value;
+}
+
+// Tells if value ends the plain part of a string: a quote, a backslash or a control character
+inline bool is_string_special(char value) noexcept {
+  return '"' == value || '\\' == value || static_cast<unsigned char>(value) < 0x20u;
+}
+
+// Returns the index of the lowest set bit of a non zero mask
+inline std::uint32_t lowest_bit(std::uint32_t mask) noexcept {
+#if defined(__GNUC__)
+  return static_cast<std::uint32_t>(__builtin_ctz(mask));
+#else
+  std::uint32_t index = 0u;
+  while (!(mask & 1u)) {
+    mask >>= 1u;
+    ++index;
+  }
+  return index;
+#endif
+}
+
+//
+// Scanners return the first position in [first, last) which they do not skip
+//
+// They test 16 characters at once with SSE2 when available, the tail being
+// scanned one character at a time.
+//
+inline char const* skip_whitespace(char const* first, char const* last) noexcept {
+  if (first == last || !is_whitespace(*first)) return first;
+#if defined(JSON_BACKBONE_TEXT_SSE2)
+  __m128i const space = _mm_set1_epi8(' ');
+  __m128i const newline = _mm_set1_epi8('\n');
+  __m128i const carriage_return = _mm_set1_epi8('\r');
+  __m128i const tab = _mm_set1_epi8('\t');
+  for (; 16 <= last - first; first += 16) {
+    __m128i const bytes = _mm_loadu_si128(reinterpret_cast<__m128i const*>(first));
+    __m128i const blank = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(bytes, space), _mm_cmpeq_epi8(bytes, newline)),
+        _mm_or_si128(_mm_cmpeq_epi8(bytes, carriage_return), _mm_cmpeq_epi8(bytes, tab)));
+    std::uint32_t const mask = ~static_cast<std::uint32_t>(_mm_movemask_epi8(blank)) & 0xFFFFu;
+    if (mask) return first + lowest_bit(mask);
+  }
+#endif
+  while (first != last && is_whitespace(*first)) ++first;
+  return first;
+}
+
+inline char const* skip_string_plain(char const* first, char const* last) noexcept {
+#if defined(JSON_BACKBONE_TEXT_SSE2)
+  __m128i const quote = _mm_set1_epi8('"');
+  __m128i const backslash = _mm_set1_epi8('\\');
+  __m128i const control = _mm_set1_epi8(0x1F);
+  for (; 16 <= last - first; first += 16) {
+    __m128i const bytes = _mm_loadu_si128(reinterpret_cast<__m128i const*>(first));
+    // Unsigned bytes below 0x20 are those left unchanged by a maximum with 0x1F
+    __m128i const special =
+        _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(bytes, quote), _mm_cmpeq_epi8(bytes, backslash)),
+                     _mm_cmpeq_epi8(_mm_max_epu8(bytes, control), control));
+    std::uint32_t const mask = static_cast<std::uint32_t>(_mm_movemask_epi8(special));
+    if (mask) return first + lowest_bit(mask);
+  }
+#endif
+  while (first != last && !is_string_special(*first)) ++first;
+  return first;
+}
+
+// Powers of ten exactly representable by a double
+inline double exact_power_of_ten(int exponent) noexcept {
+  static constexpr double powers[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                      1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                                      1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+  return powers[exponent];
+}
+}  // namespace text_helpers
+}  // namespace json_backbone
+
+#endif  // JSON_BACKBONE_TEXT_HEADER
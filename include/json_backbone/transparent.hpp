@@ -0,0 +1,86 @@
+#ifndef JSON_BACKBONE_TRANSPARENT_HEADER
+#define JSON_BACKBONE_TRANSPARENT_HEADER
+#include <json_backbone.hpp>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <string>
+#if 201703L <= __cplusplus
+#include <string_view>
+#endif
+
+namespace json_backbone {
+namespace helpers {
+// Hashes bytes a word at a time, results do not depend on how the bytes are held
+inline std::size_t hash_bytes(char const* data, std::size_t size) noexcept {
+  std::uint64_t hash = 0xcbf29ce484222325ull ^ (size * 0x9E3779B97F4A7C15ull);
+  auto mix = [&hash](std::uint64_t word) {
+    hash = (hash ^ word) * 0xff51afd7ed558ccdull;
+    hash ^= hash >> 32u;
+  };
+  for (; 8u <= size; data += 8u, size -= 8u) {
+    std::uint64_t word;
+    std::memcpy(&word, data, 8u);
+    mix(word);
+  }
+  if (size) {
+    std::uint64_t word = 0u;
+    for (std::size_t index = 0; index < size; ++index)
+      word |= static_cast<std::uint64_t>(static_cast<unsigned char>(data[index])) << (index * 8u);
+    mix(word);
+  }
+  return static_cast<std::size_t>(hash);
+}
+}  // namespace helpers
+
+//
+// string_hash is a transparent hasher for string keys
+//
+// std::string, null terminated strings and, from C++17 on, std::string_view
+// hash the same way, so that hashed objects find keys of any of these types
+// without building a temporary std::string.
+//
+struct string_hash {
+  using is_transparent = void;
+
+  std::size_t operator()(std::string const& key) const noexcept {
+    return helpers::hash_bytes(key.data(), key.size());
+  }
+
+  std::size_t operator()(char const* key) const noexcept {
+    return helpers::hash_bytes(key, std::strlen(key));
+  }
+
+#if 201703L <= __cplusplus
+  std::size_t operator()(std::string_view key) const noexcept {
+    return helpers::hash_bytes(key.data(), key.size());
+  }
+#endif
+};
+
+// Default hasher of hashed objects, string_hash for std::string keys
+template <class Key>
+struct default_hash {
+  using type = std::hash<Key>;
+};
+template <>
+struct default_hash<std::string> {
+  using type = string_hash;
+};
+template <class Key>
+using default_hash_t = typename default_hash<Key>::type;
+
+//
+// transparent_map is a std::map finding keys without converting them
+//
+// Containers already give std::map a std::less<> (see transparent_object_t),
+// the alias names the same object type outside of them:
+//
+// transparent_map<std::string, int> counts;
+//
+template <class Key, class Value>
+using transparent_map = std::map<Key, Value, std::less<>>;
+}  // namespace json_backbone
+
+#endif  // JSON_BACKBONE_TRANSPARENT_HEADER
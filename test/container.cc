@@ -1,11 +1,13 @@
 #include <iostream>
 #include <json_backbone.hpp>
+#include <json_backbone/hash.hpp>
 #include <catch.hpp>
 #include <chrono>
 #include <sstream>
 #include <list>
 #include <vector>
 #include <map>
+#include <unordered_map>
 #include <type_traits>
 
 using namespace json_backbone;
@@ -21,6 +23,28 @@ using json_container = container<std::map,        // User's choice of associativ
                                  std::string      // A type an element could take
                                  >;
 
+// Container sharing its heap values between copies
+using cow_container = container<std::map, std::vector, std::string, std::nullptr_t, std::string,
+                                int, bool, double>;
+
+namespace json_backbone {
+template <class... Others>
+struct variant_traits<std::nullptr_t, std::string, int, bool, double, Others...>
+    : default_variant_traits<std::nullptr_t, std::string, int, bool, double, Others...> {
+  static constexpr bool copy_on_write = true;
+};
+}
+
+// Resolve CATCH SFINAE trait ambiguity (error on Clang, GCC is fine)
+namespace Catch {
+namespace Detail {
+template <>
+struct IsStreamInsertable<cow_container> {
+  enum { value = false };
+};
+}
+}
+
 namespace {
 element_init<json_container> operator""_a(char const* name, size_t length) {
   return json_container::key_type{name, length};
@@ -226,3 +250,279 @@ TEST_CASE("Container - creation", "[container][access][runtime]") {
       CHECK(c2["children"].at(1)["age"].get<int>() == 8);
   }
 }
+
+TEST_CASE("Container - copy on write", "[container][cow][runtime]") {
+  cow_container original = cow_container::object_type{};
+  for (int i = 0; i < 100; ++i) {
+    original[std::to_string(i)] =
+        cow_container::array_type{std::string{"value"} + std::to_string(i), i, 0.5 * i};
+  }
+  cow_container const& const_original = original;
+  auto const* object = &const_original.get<cow_container::object_type>();
+
+  // Copies share the tree until it is mutated
+  cow_container copy{original};
+  cow_container const& const_copy = copy;
+  REQUIRE(&const_copy.get<cow_container::object_type>() == object);
+  cow_container assigned;
+  assigned = copy;
+  REQUIRE(&static_cast<cow_container const&>(assigned).get<cow_container::object_type>() == object);
+
+  // Mutable access clones the accessed level only, children stay shared
+  auto const* child = &const_original["42"].get<cow_container::array_type>();
+  copy["42"][0] = std::string{"changed"};
+  REQUIRE(&const_copy.get<cow_container::object_type>() != object);
+  REQUIRE(&const_original.get<cow_container::object_type>() == object);
+  REQUIRE(&const_copy["41"].get<cow_container::array_type>() ==
+          &const_original["41"].get<cow_container::array_type>());
+  REQUIRE(&const_copy["42"].get<cow_container::array_type>() != child);
+
+  REQUIRE(const_original["42"][0].get<std::string>() == "value42");
+  REQUIRE(const_copy["42"][0].get<std::string>() == "changed");
+  REQUIRE(static_cast<cow_container const&>(assigned)["42"][0].get<std::string>() == "value42");
+
+  // Moves hand the tree over, their source is left null
+  cow_container moved{std::move(assigned)};
+  REQUIRE(&static_cast<cow_container const&>(moved).get<cow_container::object_type>() == object);
+  REQUIRE(assigned.is<std::nullptr_t>());
+  cow_container move_assigned = cow_container::object_type{};
+  move_assigned = std::move(moved);
+  REQUIRE(moved.is<std::nullptr_t>());
+  REQUIRE(&static_cast<cow_container const&>(move_assigned).get<cow_container::object_type>() ==
+          object);
+
+  // Once unique, mutable access does not clone anymore
+  original = nullptr;
+  REQUIRE(move_assigned.get_if_unique<cow_container::object_type>() == object);
+  REQUIRE(&move_assigned.get<cow_container::object_type>() == object);
+}
+
+TEST_CASE("Container - emplace", "[container][construct][runtime]") {
+  json_container array = json_container::array_type{};
+  json_container& pushed = array.emplace_back(3u, 'x');
+  REQUIRE(pushed.get<std::string>() == "xxx");
+  array.emplace_back(1.5);
+  REQUIRE(array[1].get<double>() == 1.5);
+  REQUIRE_THROWS_AS(array.try_emplace("key", 1), bad_container_object_access);
+
+  json_container object = json_container::object_type{};
+  auto inserted = object.try_emplace("key", 2u, 'y');
+  REQUIRE(inserted.second);
+  REQUIRE(inserted.first->second.get<std::string>() == "yy");
+  auto existing = object.try_emplace("key", 1);
+  REQUIRE(!existing.second);
+  REQUIRE(existing.first->second.get<std::string>() == "yy");
+  REQUIRE_THROWS_AS(object.emplace_back(1), bad_container_array_access);
+
+  json_container value{1};
+  REQUIRE(value.emplace<json_container::array_type>(2u).size() == 2u);
+  REQUIRE(value[1].is<std::nullptr_t>());
+}
+
+TEST_CASE("Container - builders", "[container][construct][runtime]") {
+  auto c = make_object("name"_a = "Roger",  //
+                       "size"_a = 1.92,     //
+                       "children"_a = make_array(make_object("name"_a = "Martha", "age"_a = 6),
+                                                 make_object("name"_a = "Jesabelle")),
+                       "name"_a = "Duplicate");
+  REQUIRE(c.get_object().size() == 3u);
+  REQUIRE(c["name"].get<std::string>() == "Roger");
+  REQUIRE(c["children"][0]["age"].get<int>() == 6);
+  REQUIRE(c == make_object({"name"_a = "Roger",  //
+                            "size"_a = 1.92,     //
+                            "children"_a = make_array({make_object({"name"_a = "Martha", "age"_a = 6}),
+                                                       make_object({"name"_a = "Jesabelle"})})}));
+
+  json_container const single = make_array(json_container{1});
+  REQUIRE(single.get_array().size() == 1u);
+
+  SECTION("object and array builders") {
+    std::string const long_value(64, 'x');
+    json_container value{long_value};
+    char const* buffer = value.get<std::string>().data();
+
+    array_builder<json_container> array{2u};
+    array.add(std::move(value)).emplace_back(2);
+    json_container built_array = array.build();
+    REQUIRE(array.size() == 0u);
+    REQUIRE(built_array.get_array().capacity() >= 2u);
+    REQUIRE(built_array[0].get<std::string>() == long_value);
+
+    object_builder<json_container> object;
+    object.reserve(2u).add("array", std::move(built_array)).emplace("number", 3);
+    json_container built = object.build();
+    REQUIRE(built["number"].get<int>() == 3);
+    REQUIRE(built["array"][0].get<std::string>().data() == buffer);  // Moved, not copied
+  }
+}
+
+TEST_CASE("Container - hashing", "[container][hash][runtime]") {
+  auto c = make_object({"name"_a = "Roger",  //
+                        "children"_a = make_array({json_container{"Martha"}, json_container{6}}),
+                        "nothing"_a = nullptr});
+  std::hash<json_container> hash;
+  REQUIRE(hash(c) == hash(json_container{c}));
+  REQUIRE(hash(json_container{1}) != hash(json_container{2}));
+  REQUIRE(hash(json_container{1}) != hash(json_container{1.0}));
+
+  json_container other{c};
+  other["children"][1] = 7;
+  REQUIRE(hash(other) != hash(c));
+
+  // Arrays are ordered, objects are not
+  REQUIRE(hash(make_array({json_container{1}, json_container{2}})) !=
+          hash(make_array({json_container{2}, json_container{1}})));
+  REQUIRE(std::hash<json_container::variant_type>{}(c) == hash(c));
+
+  std::unordered_map<json_container, int> cache;
+  cache[c] = 1;
+  REQUIRE(cache.count(json_container{c}) == 1u);
+}
+
+TEST_CASE("Container - hash consing", "[container][hash][cow][runtime]") {
+  using array_type = cow_container::array_type;
+  using object_type = cow_container::object_type;
+
+  auto make_record = [](int index) {
+    cow_container record = object_type{};
+    record["status"] = std::string{index % 2 ? "active" : "inactive"};
+    record["tags"] = array_type{std::string{"a"}, std::string{"b"}};
+    record["id"] = index % 3;
+    return record;
+  };
+
+  cow_container document = array_type{};
+  for (int index = 0; index < 60; ++index) document.get<array_type>().push_back(make_record(index));
+
+  hash_cons<cow_container> table;
+  cow_container const interned = table.intern(document);
+  REQUIRE(interned == document);
+  REQUIRE(std::hash<cow_container>{}(interned) == std::hash<cow_container>{}(document));
+
+  // 6 records, 2 statuses, a tag array, 2 tags and the document itself
+  REQUIRE(table.size() == 12u);
+  array_type const& records = interned.get<array_type>();
+  REQUIRE(&records[0].get<object_type>() == &records[6].get<object_type>());
+  REQUIRE(&records[0].get<object_type>() != &records[1].get<object_type>());
+  REQUIRE(&records[0]["tags"].get<array_type>() == &records[1]["tags"].get<array_type>());
+
+  // Interning across documents shares with previous ones
+  cow_container const record = table.intern(make_record(4));
+  REQUIRE(&record.get<object_type>() == &records[4].get<object_type>());
+  REQUIRE(table.size() == 12u);
+
+  // Mutating an interned container leaves the table untouched
+  cow_container changed{record};
+  changed["id"] = 42;
+  REQUIRE(&static_cast<cow_container const&>(changed).get<object_type>() !=
+          &record.get<object_type>());
+  REQUIRE(record["id"].get<int>() == 1);
+}
+
+TEST_CASE("Container - comparison", "[container][compare][runtime]") {
+  auto c = make_object({"name"_a = "Roger",  //
+                        "children"_a = make_array({json_container{"Martha"}, json_container{6}})});
+  json_container copy{c};
+  REQUIRE(c == copy);
+  REQUIRE(compare(c, copy) == 0);
+  REQUIRE(!(c < copy));
+  REQUIRE(c <= copy);
+
+  copy["children"][1] = 7;
+  REQUIRE(c != copy);
+  REQUIRE(compare(c, copy) < 0);
+  REQUIRE(c < copy);
+  REQUIRE(copy > c);
+
+  // Same ordering as variant: by type index first, then lexicographically
+  REQUIRE(json_container{nullptr} < json_container{false});
+  REQUIRE(compare(json_container{nullptr}, json_container{nullptr}) == 0);
+  REQUIRE(json_container{2} > json_container{1});
+  REQUIRE(make_array({json_container{1}}) < make_array({json_container{1}, json_container{0}}));
+  REQUIRE(make_array({json_container{2}}) > make_array({json_container{1}, json_container{0}}));
+  REQUIRE(make_object({"a"_a = 2}) < make_object({"b"_a = 1}));
+  REQUIRE(make_object({"a"_a = 1}) < make_object({"a"_a = 2}));
+  REQUIRE(make_object({"a"_a = 1}) < make_object({"a"_a = 1, "b"_a = 0}));
+  REQUIRE(make_object({"a"_a = 1}) != make_object({"b"_a = 1}));
+
+  SECTION("deeply nested containers") {
+    auto nest = [](std::size_t depth, int leaf) {
+      json_container value{leaf};
+      for (std::size_t level = 0; level < depth; ++level) {
+        json_container::array_type array;
+        array.push_back(std::move(value));
+        value = std::move(array);
+      }
+      return value;
+    };
+    json_container const deep = nest(5000u, 1);
+    REQUIRE(deep == nest(5000u, 1));
+    REQUIRE(deep != nest(5000u, 2));
+    REQUIRE(deep < nest(5000u, 2));
+    REQUIRE(compare(deep, nest(4999u, 1)) > 0);  // Ints are ordered before arrays
+  }
+}
+
+TEST_CASE("Container - deep hashing", "[container][hash][runtime]") {
+  std::size_t const depth = 100000u;  // Arrays of objects, twice as many levels
+  auto nest = [depth](int leaf) {
+    cow_container value{leaf};
+    for (std::size_t level = 0; level < depth; ++level) {
+      cow_container::object_type object;
+      object.emplace("child", std::move(value));
+      cow_container::array_type array;
+      array.push_back(cow_container{std::move(object)});
+      value = std::move(array);
+    }
+    return value;
+  };
+
+  cow_container const deep = nest(1);
+  REQUIRE(std::hash<cow_container>{}(deep) == std::hash<cow_container>{}(nest(1)));
+  REQUIRE(std::hash<cow_container>{}(deep) != std::hash<cow_container>{}(nest(2)));
+
+  hash_cons<cow_container> table;
+  cow_container const interned = table.intern(deep);
+  REQUIRE(table.size() == 2u * depth);  // The inline leaf is not a node
+  REQUIRE(interned == deep);
+  REQUIRE(std::hash<cow_container>{}(interned) == std::hash<cow_container>{}(deep));
+  cow_container const again = table.intern(nest(1));
+  REQUIRE(&again.get<cow_container::array_type>() == &interned.get<cow_container::array_type>());
+}
+
+TEST_CASE("Container - deep teardown", "[container][destroy][runtime]") {
+  std::size_t const depth = 200000u;
+
+  SECTION("nested arrays") {
+    json_container value{1};
+    for (std::size_t level = 0; level < depth; ++level) {
+      json_container::array_type array;
+      array.push_back(std::move(value));
+      value = std::move(array);
+    }
+    REQUIRE(value.is<json_container::array_type>());
+  }
+
+  SECTION("nested objects") {
+    json_container value = json_container::object_type{};
+    for (std::size_t level = 0; level < depth; ++level) {
+      json_container::object_type object;
+      object.emplace("child", std::move(value));
+      object.emplace("sibling", std::string(32, 's'));
+      value = std::move(object);
+    }
+    REQUIRE(value.get_object().size() == 2u);
+  }
+
+  SECTION("shared nested arrays") {
+    cow_container value{1};
+    for (std::size_t level = 0; level < depth; ++level) {
+      cow_container::array_type array;
+      array.push_back(std::move(value));
+      value = std::move(array);
+    }
+    cow_container copy{value};
+    value = nullptr;  // Leaves the tree to the copy
+    REQUIRE(copy.is<cow_container::array_type>());
+  }
+}
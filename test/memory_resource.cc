@@ -0,0 +1,305 @@
+#include <json_backbone.hpp>
+#include <json_backbone/pmr.hpp>
+#include <json_backbone/arena.hpp>
+#include <json_backbone/pool.hpp>
+#include <json_backbone/reclaimer.hpp>
+#include <catch.hpp>
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <vector>
+#include <type_traits>
+
+using namespace json_backbone;
+
+// Container whose collections and heap values are allocated on a memory_resource
+using pmr_container =
+    pmr::container<pmr::string, std::nullptr_t, bool, int, double, pmr::string>;
+
+namespace json_backbone {
+template <class... Others>
+struct variant_traits<std::nullptr_t, bool, int, double, pmr::string, Others...>
+    : pmr::variant_traits<std::nullptr_t, bool, int, double, pmr::string, Others...> {};
+}
+
+// Resolve CATCH SFINAE trait ambiguity (error on Clang, GCC is fine)
+namespace Catch {
+namespace Detail {
+template <>
+struct IsStreamInsertable<pmr_container> {
+  enum { value = false };
+};
+}
+}
+
+namespace {
+// Memory resource counting its allocations
+class counting_resource : public memory_resource {
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    ++allocations;
+    allocated += bytes;
+    return new_delete_resource()->allocate(bytes, alignment);
+  }
+
+  void do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) override {
+    ++deallocations;
+    deallocated += bytes;
+    new_delete_resource()->deallocate(pointer, bytes, alignment);
+  }
+
+  bool do_is_equal(memory_resource const& other) const noexcept override {
+    return this == &other;
+  }
+
+ public:
+  std::size_t allocations = 0;
+  std::size_t deallocations = 0;
+  std::size_t allocated = 0;
+  std::size_t deallocated = 0;
+};
+
+// Stateless allocator counting its allocations in globals
+std::size_t stateless_allocations = 0;
+std::size_t stateless_deallocations = 0;
+
+template <class T>
+struct counting_allocator {
+  using value_type = T;
+  counting_allocator() = default;
+  template <class U>
+  counting_allocator(counting_allocator<U> const&) noexcept {}
+  T* allocate(std::size_t size) {
+    ++stateless_allocations;
+    return std::allocator<T>{}.allocate(size);
+  }
+  void deallocate(T* pointer, std::size_t size) {
+    ++stateless_deallocations;
+    std::allocator<T>{}.deallocate(pointer, size);
+  }
+};
+template <class T, class U>
+bool operator==(counting_allocator<T> const&, counting_allocator<U> const&) {
+  return true;
+}
+template <class T, class U>
+bool operator!=(counting_allocator<T> const&, counting_allocator<U> const&) {
+  return false;
+}
+
+struct counted_marker {};
+struct pooled_marker {};
+}
+
+namespace json_backbone {
+template <class... Others>
+struct variant_traits<counted_marker, Others...>
+    : default_variant_traits<counted_marker, Others...> {
+  using allocator_type = counting_allocator<char>;
+};
+
+template <class... Others>
+struct variant_traits<pooled_marker, Others...> : default_variant_traits<pooled_marker, Others...> {
+  using allocator_type = pool_allocator<char>;
+};
+}
+
+TEST_CASE("Memory resource - Default resource", "[memory][runtime]") {
+  counting_resource resource;
+  memory_resource* initial = get_default_resource();
+  REQUIRE(initial == new_delete_resource());
+  {
+    default_resource_guard guard{resource};
+    REQUIRE(get_default_resource() == &resource);
+    REQUIRE(polymorphic_allocator<int>{}.resource() == &resource);
+  }
+  REQUIRE(get_default_resource() == initial);
+  REQUIRE(set_default_resource(&resource) == initial);
+  REQUIRE(set_default_resource(nullptr) == &resource);
+  REQUIRE(get_default_resource() == new_delete_resource());
+  REQUIRE(polymorphic_allocator<int>{&resource} != polymorphic_allocator<int>{});
+}
+
+TEST_CASE("Memory resource - Documents", "[memory][container][runtime]") {
+  counting_resource resource;
+  {
+    pmr_container c = make_object<pmr_container>(
+        resource,
+        {{"name", pmr::string{"a string long enough to avoid the small string optimization"}},
+         {"values", make_array<pmr_container>(resource, {1, 2.5, nullptr, true})},
+         {"nested", make_object<pmr_container>(resource, {{"key", 42}})}});
+    REQUIRE(get_default_resource() == new_delete_resource());
+    REQUIRE(0u < resource.allocations);
+    REQUIRE(c["nested"]["key"].get<int>() == 42);
+    REQUIRE(c["values"][1].get<double>() == 2.5);
+    REQUIRE(c.get<pmr_container::object_type>().get_allocator().resource() == &resource);
+
+    // Copies go to the default resource, moves keep the resource
+    std::size_t allocations = resource.allocations;
+    pmr_container copy = c;
+    REQUIRE(resource.allocations == allocations);
+    REQUIRE(copy.get<pmr_container::object_type>().get_allocator().resource() ==
+            new_delete_resource());
+    pmr_container moved = std::move(c);
+    REQUIRE(moved.get<pmr_container::object_type>().get_allocator().resource() == &resource);
+  }
+  REQUIRE(resource.allocations == resource.deallocations);
+  REQUIRE(resource.allocated == resource.deallocated);
+}
+
+TEST_CASE("Memory resource - Heap values", "[memory][variant][runtime]") {
+  using counted_variant = variant<counted_marker, bool, std::string>;
+  stateless_allocations = stateless_deallocations = 0;
+  {
+    counted_variant v{std::string{"heap"}};
+    counted_variant b{true};
+    REQUIRE(stateless_allocations == 1u);
+    v = false;
+    REQUIRE(stateless_deallocations == 1u);
+    v = std::string{"heap again"};
+    REQUIRE(v.get<std::string>() == "heap again");
+  }
+  REQUIRE(stateless_allocations == 2u);
+  REQUIRE(stateless_deallocations == 2u);
+}
+
+TEST_CASE("Memory resource - Arena documents", "[memory][arena][runtime]") {
+  using plain_container = container<std::map, std::vector, std::string, std::nullptr_t, bool, int,
+                                    double, std::string>;
+  static_assert(is_trivially_releasable<pmr_container>::value, "");
+  static_assert(!is_trivially_releasable<plain_container>::value, "");
+
+  counting_resource upstream;
+  {
+    arena_document<pmr_container> document{1024u, &upstream};
+    for (int round = 0; round < 3; ++round) {
+      {
+        auto scope = document.scope();
+        pmr_container& root = document.root();
+        root = pmr_container::object_type{};
+        for (int i = 0; i < 200; ++i) {
+          root[pmr::string{"key"} + std::to_string(i).c_str()] = make_array<pmr_container>(
+              {i, 0.5 * i, pmr::string{"a string long enough to avoid small buffers"}});
+        }
+      }
+      REQUIRE(get_default_resource() == new_delete_resource());
+      REQUIRE(document.root()["key199"][0].get<int>() == 199);
+      REQUIRE(document.root()["key42"][2].get<pmr::string>().size() == 43u);
+      document.reset();
+      REQUIRE(document.root().is<std::nullptr_t>());
+    }
+    // Chunks grow geometrically and the largest one is reused on reset
+    REQUIRE(upstream.allocations < 30u);
+    REQUIRE(upstream.allocations == upstream.deallocations + 1u);
+  }
+  REQUIRE(upstream.allocations == upstream.deallocations);
+  REQUIRE(upstream.allocated == upstream.deallocated);
+
+  // Containers which are not trivially releasable are still destroyed
+  arena_document<plain_container> document{};
+  auto scope = document.scope();
+  document.root() = make_array<plain_container>({std::string(100, 'x'), 1, 2.0});
+  REQUIRE(document.root()[0].get<std::string>().size() == 100u);
+}
+
+TEST_CASE("Memory resource - Pooled heap values", "[memory][pool][runtime]") {
+  using pooled_variant = variant<pooled_marker, int, std::string, std::vector<int>>;
+  size_class_pool& pool = size_class_pool::local();
+  pool.trim();
+  pool_stats const before = pool.stats();
+  {
+    std::vector<pooled_variant> values;
+    values.reserve(64u);
+    for (int round = 0; round < 4; ++round) {
+      for (int i = 0; i < 64; ++i) {
+        if (i % 2) {
+          values.emplace_back(std::string{"pooled"});
+        } else {
+          values.emplace_back(std::vector<int>(4, i));
+        }
+      }
+      REQUIRE(values[2].get<std::vector<int>>()[3] == 2);
+      values.clear();
+    }
+  }
+  pool_stats const after = pool.stats();
+  REQUIRE(after.allocations - before.allocations == 256u);
+  REQUIRE(after.deallocations - before.deallocations == 256u);
+  // Only the first round reaches the global allocator
+  REQUIRE(after.reuses - before.reuses == 192u);
+  REQUIRE(after.cached_blocks == 64u);
+  REQUIRE(0u < after.cached_bytes);
+
+  pool.trim();
+  REQUIRE(pool.stats().cached_blocks == 0u);
+  REQUIRE(pool.stats().cached_bytes == 0u);
+
+  // Wide blocks are not cached
+  void* wide = pool.allocate(size_class_pool::max_size + 1u);
+  pool.deallocate(wide, size_class_pool::max_size + 1u);
+  REQUIRE(pool.stats().cached_blocks == 0u);
+}
+
+TEST_CASE("Memory resource - Deferred reclamation", "[memory][reclaimer][runtime]") {
+  using plain_container = container<std::map, std::vector, std::string, std::nullptr_t, bool, int,
+                                    double, std::string>;
+  auto make_document = [] {
+    plain_container document = plain_container::array_type{};
+    for (int i = 0; i < 100; ++i)
+      document.get_array().push_back(make_object<plain_container>({{"id", i}, {"tag", "x"}}));
+    return document;
+  };
+
+  plain_container sample = make_document();
+  footprint const size = measure_footprint(sample);
+  REQUIRE(size.nodes == 301u);
+  REQUIRE(301u * sizeof(plain_container) < size.bytes);
+
+  // Measures stop once over their limit
+  footprint const partial = measure_footprint(sample, footprint{100u, size.bytes});
+  REQUIRE(100u < partial.nodes);
+  REQUIRE(partial.nodes < size.nodes);
+  REQUIRE(301u < measure_footprint(sample, footprint{301u, size.bytes - 1u}).bytes);
+
+  reclaimer<plain_container> queue{2u * size.nodes};
+  for (int round = 0; round < 8; ++round) {
+    plain_container document = make_document();
+    queue.retire(std::move(document));
+  }
+  queue.drain();
+  reclaimer_stats const stats = queue.stats();
+  REQUIRE(stats.pending_documents == 0u);
+  REQUIRE(stats.pending_nodes == 0u);
+  REQUIRE(stats.pending_bytes == 0u);
+  REQUIRE(stats.reclaimed_documents + stats.inline_documents == 8u);
+  REQUIRE(stats.reclaimed_nodes == stats.reclaimed_documents * size.nodes);
+  REQUIRE(stats.reclaimed_bytes == stats.reclaimed_documents * size.bytes);
+
+  // Scalars are destroyed in place and documents over the limits by retire
+  REQUIRE_FALSE(queue.retire(plain_container{42}));
+  reclaimer<plain_container> small{size.nodes - 1u};
+  REQUIRE_FALSE(small.retire(make_document()));
+  REQUIRE(small.stats().inline_documents == 1u);
+
+  // Nested documents count every node against the bounds
+  auto make_chain = [](std::size_t depth) {
+    plain_container chain = nullptr;
+    for (std::size_t level = 0; level < depth; ++level) {
+      plain_container::array_type array;
+      array.push_back(std::move(chain));
+      chain = std::move(array);
+    }
+    return chain;
+  };
+  plain_container chain = make_chain(1000u);
+  REQUIRE(measure_footprint(chain).nodes == 1001u);
+  reclaimer<plain_container> bounded{1000u};
+  REQUIRE(bounded.retire(make_chain(500u)));
+  REQUIRE_FALSE(bounded.retire(make_chain(100000u)));
+  REQUIRE(bounded.stats().inline_documents == 1u);
+  bounded.drain();
+  REQUIRE(bounded.stats().reclaimed_nodes == 501u);
+
+  REQUIRE(retire(make_document()));
+  reclaimer<plain_container>::global().drain();
+  REQUIRE(reclaimer<plain_container>::global().stats().reclaimed_documents == 1u);
+}
@@ -0,0 +1,304 @@
+#include <json_backbone.hpp>
+#include <json_backbone/flat_object.hpp>
+#include <json_backbone/hybrid_object.hpp>
+#include <json_backbone/symbol.hpp>
+#include <json_backbone/transparent.hpp>
+#include <catch.hpp>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace json_backbone;
+
+// Containers using the object types shipped with the library
+using flat_container =
+    container<flat_object, std::vector, std::string, std::nullptr_t, bool, int, double, std::string>;
+using hybrid_container = container<hybrid_object, std::vector, std::string, std::nullptr_t, bool,
+                                   int, double, std::string>;
+using transparent_container = container<transparent_map, std::vector, std::string, std::nullptr_t,
+                                        bool, int, double, std::string>;
+using symbol_container =
+    container<std::map, std::vector, symbol, std::nullptr_t, bool, int, double, std::string>;
+
+// Resolve CATCH SFINAE trait ambiguity (error on Clang, GCC is fine)
+namespace Catch {
+namespace Detail {
+template <>
+struct IsStreamInsertable<flat_container> {
+  enum { value = false };
+};
+template <>
+struct IsStreamInsertable<hybrid_container> {
+  enum { value = false };
+};
+template <>
+struct IsStreamInsertable<transparent_container> {
+  enum { value = false };
+};
+template <>
+struct IsStreamInsertable<symbol_container> {
+  enum { value = false };
+};
+}
+}
+
+namespace {
+element_init<flat_container> operator""_f(char const* name, size_t length) {
+  return flat_container::key_type{name, length};
+}
+
+element_init<hybrid_container> operator""_h(char const* name, size_t length) {
+  return hybrid_container::key_type{name, length};
+}
+
+element_init<symbol_container> operator""_s(char const* name, size_t length) {
+  return symbol_container::key_type{name, length};
+}
+
+// Comparable with std::string but not convertible to it
+struct key_probe {
+  char const* text;
+};
+bool operator<(std::string const& lhs, key_probe rhs) { return lhs.compare(rhs.text) < 0; }
+bool operator<(key_probe lhs, std::string const& rhs) { return rhs.compare(lhs.text) > 0; }
+
+// Sends every key to the same group to exercise probing
+struct colliding_hash {
+  std::size_t operator()(int) const noexcept { return 0u; }
+};
+
+// Throws once armed, to interrupt index rebuilds
+struct failing_hash {
+  static bool armed;
+  std::size_t operator()(int value) const {
+    if (armed) throw std::runtime_error{"hash"};
+    return std::hash<int>{}(value);
+  }
+};
+bool failing_hash::armed = false;
+}
+
+TEST_CASE("Objects - flat_object", "[objects][flat][runtime]") {
+  flat_object<std::string, int> object{{"b", 2}, {"a", 1}, {"c", 3}, {"a", 4}};
+  REQUIRE(object.size() == 3u);
+  REQUIRE(object.begin()->first == "a");
+  REQUIRE(object.at("a") == 1);  // First duplicate wins, as with std::map
+  REQUIRE(object.find("d") == object.end());
+  REQUIRE(object.count("b") == 1u);
+
+  object["d"] = 5;
+  object["0"] = 6;
+  REQUIRE(object.size() == 5u);
+  REQUIRE(object.begin()->first == "0");
+  REQUIRE(object.rbegin()->first == "d");
+  REQUIRE(!object.try_emplace("b", 7).second);
+  REQUIRE(object.emplace("e", 8).second);
+  REQUIRE(object.erase("0") == 1u);
+  REQUIRE(object.erase("0") == 0u);
+  REQUIRE_THROWS_AS(object.at("0"), std::out_of_range);
+
+  std::string keys;
+  for (auto const& element : object) keys += element.first;
+  REQUIRE(keys == "abcde");
+
+  flat_object<std::string, int> copy{object};
+  REQUIRE(copy == object);
+  copy["a"] = 0;
+  REQUIRE(copy < object);
+}
+
+TEST_CASE("Objects - flat_object in containers", "[objects][flat][container][runtime]") {
+  auto c = make_object({
+      "name"_f = "Roger",                                               //
+      "size"_f = 1.92,                                                  //
+      "subscribed"_f = true,                                            //
+      "children"_f = flat_container::array_type{"Martha", "Jesabelle"}  //
+  });
+
+  REQUIRE(c["name"].get<std::string>() == "Roger");
+  REQUIRE(c["children"][1].get<std::string>() == "Jesabelle");
+  c["age"] = 42;
+  REQUIRE(c.get_object().size() == 5u);
+  REQUIRE(c.try_emplace("age", 1).first->second.get<int>() == 42);
+
+  flat_container const& const_c = c;
+  REQUIRE_THROWS_AS(const_c["missing"], bad_container_object_access);
+  REQUIRE(c == flat_container{c});
+
+  std::ostringstream output;
+  for (auto& value : make_view(c)) output << value.key();
+  REQUIRE(output.str() == "agechildrennamesizesubscribed");
+}
+
+TEST_CASE("Objects - hybrid_object", "[objects][hybrid][runtime]") {
+  hybrid_object<std::string, int> object{{"b", 2}, {"a", 1}, {"c", 3}, {"a", 4}};
+  REQUIRE(object.size() == 3u);
+  REQUIRE(!object.indexed());
+  REQUIRE(object.begin()->first == "b");  // Insertion order
+  REQUIRE(object.at("a") == 1);
+  REQUIRE(object.find("d") == object.end());
+  REQUIRE(!object.try_emplace("b", 7).second);
+  REQUIRE(object.erase("b") == 1u);
+  REQUIRE(object.erase("b") == 0u);
+  REQUIRE(object.begin()->first == "c");  // Last element moved in place of the erased one
+  REQUIRE_THROWS_AS(object.at("b"), std::out_of_range);
+
+  hybrid_object<std::string, int> reordered{{"a", 1}, {"c", 3}};
+  REQUIRE(reordered == object);
+  reordered["a"] = 0;
+  REQUIRE(reordered != object);
+
+  SECTION("growing beyond the small size builds the index") {
+    hybrid_object<int, int> large;
+    for (int index = 0; index < 10000; ++index) large[index * 3] = index;
+    REQUIRE(large.indexed());
+    REQUIRE(large.size() == 10000u);
+    for (int index = 0; index < 10000; ++index) REQUIRE(large.at(index * 3) == index);
+    REQUIRE(large.count(1) == 0u);
+
+    for (int index = 0; index < 10000; index += 2) REQUIRE(large.erase(index * 3) == 1u);
+    REQUIRE(large.size() == 5000u);
+    for (int index = 0; index < 10000; ++index) REQUIRE(large.count(index * 3) == index % 2u);
+    for (auto const& element : large) REQUIRE(element.first == element.second * 3);
+
+    // Reuses deleted slots
+    for (int index = 0; index < 10000; index += 2) large.try_emplace(index * 3, index);
+    for (int index = 0; index < 10000; ++index) REQUIRE(large.at(index * 3) == index);
+  }
+
+  SECTION("colliding keys") {
+    hybrid_object<int, int, colliding_hash> colliding;
+    for (int index = 0; index < 100; ++index) colliding.emplace(index, -index);
+    REQUIRE(colliding.indexed());
+    for (int index = 0; index < 100; ++index) REQUIRE(colliding.at(index) == -index);
+    REQUIRE(colliding.erase(colliding.find(50)) != colliding.end());
+    REQUIRE(colliding.count(50) == 0u);
+    REQUIRE(colliding.at(99) == -99);
+  }
+
+  SECTION("a failed rebuild leaves the elements looked up by linear scans") {
+    hybrid_object<int, int, failing_hash> failing;
+    for (int index = 0; index < 14; ++index) failing.emplace(index, -index);
+    REQUIRE(failing.indexed());
+    failing_hash::armed = true;
+    REQUIRE_THROWS_AS(failing.reserve(1000u), std::runtime_error);
+    failing_hash::armed = false;
+    REQUIRE(!failing.indexed());
+    for (int index = 0; index < 14; ++index) REQUIRE(failing.at(index) == -index);
+    failing.emplace(14, -14);
+    REQUIRE(failing.indexed());
+    for (int index = 0; index < 15; ++index) REQUIRE(failing.at(index) == -index);
+  }
+}
+
+TEST_CASE("Objects - hybrid_object in containers", "[objects][hybrid][container][runtime]") {
+  auto c = make_object({
+      "name"_h = "Roger",                                                 //
+      "size"_h = 1.92,                                                    //
+      "subscribed"_h = true,                                              //
+      "children"_h = hybrid_container::array_type{"Martha", "Jesabelle"}  //
+  });
+
+  REQUIRE(c["name"].get<std::string>() == "Roger");
+  REQUIRE(c["children"][1].get<std::string>() == "Jesabelle");
+  for (int index = 0; index < 20; ++index) c["field_" + std::to_string(index)] = index;
+  REQUIRE(c.get_object().indexed());
+  REQUIRE(c["field_12"].get<int>() == 12);
+  REQUIRE(c.try_emplace("field_3", 1).first->second.get<int>() == 3);
+
+  hybrid_container const& const_c = c;
+  REQUIRE_THROWS_AS(const_c["missing"], bad_container_object_access);
+  REQUIRE(c == hybrid_container{c});
+
+  std::ostringstream output;
+  for (auto& value : make_view(c)) {
+    if (value.key().compare(0, 6, "field_")) output << value.key();
+  }
+  REQUIRE(output.str() == "namesizesubscribedchildren");
+}
+
+TEST_CASE("Objects - symbol keys", "[objects][symbol][runtime]") {
+  symbol_table table;
+  symbol const name{table, "name"};
+  REQUIRE(name == symbol(table, std::string{"name"}));
+  REQUIRE(name != symbol(table, "size"));
+  REQUIRE(name.str() == "name");
+  REQUIRE(symbol(table, "") == symbol());
+  REQUIRE(table.size() == 2u);
+
+  // Finding a string does not intern it
+  REQUIRE(table.find("name", 4u) == name);
+  REQUIRE(table.find(std::string{"missing"}).is_null());
+  REQUIRE(table.find(std::string{"missing"}) != symbol());
+  REQUIRE(table.size() == 2u);
+
+  // Symbols are ordered by interning order
+  REQUIRE(name < symbol(table, "size"));
+  REQUIRE(symbol(table, "size") < symbol(table, "alpha"));
+  REQUIRE(table.size() == 3u);
+
+  SECTION("in containers") {
+    default_symbol_table_guard guard{table};
+    auto c = make_object({
+        "name"_s = "Roger",                                                 //
+        "size"_s = 1.92,                                                    //
+        "children"_s = symbol_container::array_type{"Martha", "Jesabelle"}  //
+    });
+    REQUIRE(table.size() == 4u);
+    REQUIRE(c[name].get<std::string>() == "Roger");
+    REQUIRE(c["children"][1].get<std::string>() == "Jesabelle");
+    REQUIRE(make_view(c)[name].get<std::string>() == "Roger");
+    REQUIRE(make_view(c)["size"].get<double>() == 1.92);
+
+    // Read-only lookups of missing keys leave the table unchanged
+    symbol_container const& const_c = c;
+    REQUIRE(make_view(c)["missing"].empty());
+    REQUIRE_THROWS_AS(const_c["missing"], bad_container_object_access);
+    REQUIRE(const_c["size"].get<double>() == 1.92);
+    REQUIRE(table.size() == 4u);
+
+    // Keys iterate in interning order
+    std::string order;
+    for (auto& value : make_view(c)) order += value.key().str() + ' ';
+    REQUIRE(order == "name size children ");
+
+    std::size_t length = 0u;
+    for (auto& value : make_view(c)) length += value.key().size();
+    REQUIRE(length == 16u);
+
+    // Keys are shared by every object
+    auto copy = make_object({"name"_s = "Martha"});
+    REQUIRE(copy.get_object().begin()->first.c_str() == name.c_str());
+    REQUIRE(table.size() == 4u);
+  }
+
+  REQUIRE(&get_default_symbol_table() == &symbol_table::global());
+}
+
+TEST_CASE("Objects - transparent lookup", "[objects][transparent][runtime]") {
+  static_assert(has_transparent_lookup<flat_container::object_type>::value, "");
+  static_assert(has_transparent_lookup<hybrid_container::object_type>::value, "");
+  static_assert(has_transparent_lookup<transparent_container::object_type>::value, "");
+  static_assert(!has_transparent_lookup<std::map<std::string, int>>::value, "");
+  static_assert(!has_transparent_lookup<hybrid_object<symbol, int>>::value, "");
+
+  REQUIRE(string_hash{}("a long enough key") == string_hash{}(std::string{"a long enough key"}));
+  REQUIRE(string_hash{}("key") != string_hash{}("kez"));
+
+  transparent_container const t = transparent_container::object_type{{"name", "Roger"}};
+  REQUIRE(t[key_probe{"name"}].get<std::string>() == "Roger");
+  REQUIRE(make_view(t)[key_probe{"name"}].get<std::string>() == "Roger");
+  REQUIRE(make_view(t)[key_probe{"size"}].empty());
+
+  flat_container const f = make_object({"name"_f = "Roger"});
+  REQUIRE(f[key_probe{"name"}].get<std::string>() == "Roger");
+  REQUIRE(f.get_object().count(key_probe{"size"}) == 0u);
+
+  hybrid_container h = make_object({"name"_h = "Roger"});
+  for (int index = 0; index < 20; ++index) h["field_" + std::to_string(index)] = index;
+  char const* key = "field_7";
+  REQUIRE(make_view(h)[key].get<int>() == 7);
+  REQUIRE(h.get_object().count("field_20") == 0u);
+}
@@ -0,0 +1,111 @@
+#include <json_backbone.hpp>
+#include <json_backbone/flat_object.hpp>
+#include <json_backbone/parser.hpp>
+#include <catch.hpp>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace json_backbone;
+
+using json_container =
+    container<std::map, std::vector, std::string, std::nullptr_t, bool, int, double, std::string>;
+using wide_container = container<flat_object, std::vector, std::string, std::nullptr_t, bool, int,
+                                 long long, double, std::string>;
+using unsigned_container = container<std::map, std::vector, std::string, std::nullptr_t, bool, int,
+                                     long long, unsigned long long, double, std::string>;
+
+TEST_CASE("Parser - values", "[parser][runtime]") {
+  json_container const document = parse<json_container>(
+      " {\"name\": \"value\", \"int\": -42, \"real\": 2.5e1, \"yes\": true, \"no\": false,\n"
+      "  \"none\": null, \"list\": [1, [], {}, [[\"deep\"]]], \"name\": \"duplicate\"} ");
+  REQUIRE(document.get_object().size() == 7u);
+  REQUIRE(document["name"].get<std::string>() == "value");
+  REQUIRE(document["int"].get<int>() == -42);
+  REQUIRE(document["real"].get<double>() == 25.);
+  REQUIRE(document["yes"].get<bool>());
+  REQUIRE_FALSE(document["no"].get<bool>());
+  REQUIRE(document["none"].is<std::nullptr_t>());
+  REQUIRE(document["list"].get_array().size() == 4u);
+  REQUIRE(document["list"][1].get_array().empty());
+  REQUIRE(document["list"][2].get_object().empty());
+  REQUIRE(document["list"][3][0][0].get<std::string>() == "deep");
+
+  REQUIRE(parse<json_container>("3").get<int>() == 3);
+  REQUIRE(parse<json_container>("\"\"").get<std::string>().empty());
+}
+
+TEST_CASE("Parser - numbers", "[parser][runtime]") {
+  // Integers take the alternative selected for the narrowest C++ integer holding them
+  REQUIRE(parse<json_container>("-2147483648").get<int>() == -2147483647 - 1);
+  REQUIRE(parse<json_container>("2147483648").get<double>() == 2147483648.);
+  REQUIRE(parse<wide_container>("2147483648").get<long long>() == 2147483648ll);
+  REQUIRE(parse<wide_container>("-9223372036854775808").get<long long>() ==
+          -9223372036854775807ll - 1);
+  REQUIRE(parse<wide_container>("-0").get<int>() == 0);
+
+  // Integers up to the unsigned 64 bits maximum are kept exact
+  REQUIRE(parse<unsigned_container>("9223372036854775808").get<unsigned long long>() ==
+          9223372036854775808ull);
+  REQUIRE(parse<unsigned_container>("10000000000000000000").get<unsigned long long>() ==
+          10000000000000000000ull);
+  REQUIRE(parse<unsigned_container>("18446744073709551615").get<unsigned long long>() ==
+          18446744073709551615ull);
+  REQUIRE(parse<unsigned_container>("18446744073709551616").get<double>() ==
+          18446744073709551616.);
+  REQUIRE(parse<unsigned_container>("184467440737095516150").get<double>() ==
+          184467440737095516150.);
+  REQUIRE(parse<json_container>("18446744073709551615.5").get<double>() ==
+          18446744073709551615.5);
+
+  REQUIRE(parse<json_container>("0.1").get<double>() == 0.1);
+  REQUIRE(parse<json_container>("-1.5E-3").get<double>() == -1.5e-3);
+  REQUIRE(parse<json_container>("1e300").get<double>() == 1e300);
+  REQUIRE(parse<json_container>("0.30000000000000004").get<double>() == 0.30000000000000004);
+  REQUIRE(parse<json_container>("123456789012345678901234567890").get<double>() ==
+          123456789012345678901234567890.);
+  REQUIRE(parse<json_container>("2.2250738585072014e-308").get<double>() ==
+          2.2250738585072014e-308);
+}
+
+TEST_CASE("Parser - strings", "[parser][runtime]") {
+  std::string const long_text(100u, 'x');
+  REQUIRE(parse<json_container>("\"" + long_text + "\"").get<std::string>() == long_text);
+  REQUIRE(parse<json_container>(R"("a\"b\\c\/d\b\f\n\r\t")").get<std::string>() ==
+          "a\"b\\c/d\b\f\n\r\t");
+  REQUIRE(parse<json_container>(R"("\u0041\u00e9\u20AC\ud83d\ude00")").get<std::string>() ==
+          "A\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80");
+  REQUIRE(parse<json_container>("\"" + long_text + "\\n" + long_text + "\"").get<std::string>() ==
+          long_text + "\n" + long_text);
+
+  wide_container const keys = parse<wide_container>(R"({"b\n": 1, "a": 2})");
+  REQUIRE(keys["b\n"].get<int>() == 1);
+  REQUIRE(keys.get_object().begin()->first == "a");
+}
+
+TEST_CASE("Parser - errors", "[parser][runtime]") {
+  for (char const* text :
+       {"", " ", "[", "[1,]", "{\"a\" 1}", "{\"a\":1,}", "{1:2}", "tru", "nul", "01", "-", "1.",
+        "1e", "+1", "\"abc", "\"\\x\"", "\"\\ud800\"", "\"a\nb\"", "[1] 2", "{\"a\":[}"}) {
+    INFO(text);
+    REQUIRE_THROWS_AS(parse<json_container>(text), parse_error);
+  }
+  std::size_t offset = 0u;
+  try {
+    parse<json_container>("[1, 2, x]");
+  } catch (parse_error const& error) {
+    offset = error.offset();
+  }
+  REQUIRE(offset == 7u);
+
+  // Nesting depth is only bounded by memory
+  std::size_t const depth = 100000u;
+  parser<json_container> reused;
+  json_container deep = reused.parse(std::string(depth, '[') + std::string(depth, ']'));
+  for (std::size_t level = 1; level < depth; ++level) {
+    json_container next = std::move(deep.get_array().front());
+    deep = std::move(next);
+  }
+  REQUIRE(deep.get_array().empty());
+  REQUIRE(reused.parse("[true]")[0].get<bool>());
+}
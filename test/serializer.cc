@@ -0,0 +1,94 @@
+#include <json_backbone.hpp>
+#include <json_backbone/parser.hpp>
+#include <json_backbone/serializer.hpp>
+#include <catch.hpp>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace json_backbone;
+
+using json_container =
+    container<std::map, std::vector, std::string, std::nullptr_t, bool, int, double, std::string>;
+using wide_container = container<std::map, std::vector, std::string, std::nullptr_t, bool, int,
+                                 long long, float, double, std::string>;
+
+TEST_CASE("Serializer - values", "[serializer][runtime]") {
+  json_container const document = make_object<json_container>(
+      {{"name", "value"},
+       {"int", -42},
+       {"real", 2.5},
+       {"yes", true},
+       {"none", nullptr},
+       {"list", make_array<json_container>({1, json_container::array_type{},
+                                            json_container::object_type{}, std::string{"x"}})}});
+  REQUIRE(to_json(document) ==
+          R"({"int":-42,"list":[1,[],{},"x"],"name":"value","none":null,"real":2.5,"yes":true})");
+  REQUIRE(to_json(document["list"], 2u) == "[\n  1,\n  [],\n  {},\n  \"x\"\n]");
+  REQUIRE(to_json(make_object<json_container>({{"a", make_array<json_container>({1})}}), 2u) ==
+          "{\n  \"a\": [\n    1\n  ]\n}");
+  REQUIRE(to_json(json_container{}) == "null");
+
+  // Streams are sinks
+  std::ostringstream stream;
+  serialize(document["list"], stream);
+  REQUIRE(stream.str() == R"([1,[],{},"x"])");
+}
+
+TEST_CASE("Serializer - numbers", "[serializer][runtime]") {
+  REQUIRE(to_json(wide_container{std::numeric_limits<int>::min()}) == "-2147483648");
+  REQUIRE(to_json(wide_container{std::numeric_limits<long long>::max()}) ==
+          "9223372036854775807");
+  REQUIRE(to_json(wide_container{0}) == "0");
+
+  // Doubles are written with the fewest digits reading back as the same value
+  REQUIRE(to_json(json_container{0.1}) == "0.1");
+  REQUIRE(to_json(json_container{1.}) == "1.0");
+  REQUIRE(to_json(json_container{-0.}) == "-0.0");
+  REQUIRE(to_json(json_container{0.05}) == "0.05");
+  REQUIRE(to_json(json_container{123456.789}) == "123456.789");
+  REQUIRE(to_json(json_container{0.1 + 0.2}) == "0.30000000000000004");
+  REQUIRE(to_json(json_container{1e300}) == "1e+300");
+  REQUIRE(to_json(json_container{std::numeric_limits<double>::quiet_NaN()}) == "null");
+  REQUIRE(to_json(json_container{-std::numeric_limits<double>::infinity()}) == "null");
+  REQUIRE(to_json(wide_container{0.5f}) == "0.5");
+
+  std::mt19937_64 engine{42u};
+  std::uniform_real_distribution<double> uniform{-1e6, 1e6};
+  for (int draw = 0; draw < 10000; ++draw) {
+    double const value = draw % 2 ? uniform(engine) : std::ldexp(uniform(engine), draw % 200 - 100);
+    INFO(value);
+    REQUIRE(parse<json_container>(to_json(json_container{value})).get<double>() == value);
+  }
+}
+
+TEST_CASE("Serializer - strings", "[serializer][runtime]") {
+  REQUIRE(to_json(json_container{std::string{"a\"b\\c/d\b\f\n\r\t\x01\x1f"}}) ==
+          R"("a\"b\\c/d\b\f\n\r\t\u0001\u001f")");
+  REQUIRE(to_json(json_container{std::string{"\xC3\xA9t\xC3\xA9"}}) == "\"\xC3\xA9t\xC3\xA9\"");
+
+  std::string long_text(10000u, 'x');
+  long_text[5000] = '\n';
+  json_container const document = make_object<json_container>({{long_text, long_text}});
+  std::string const text = to_json(document);
+  REQUIRE(text.size() == 2u * (long_text.size() + 3u) + 3u);
+  REQUIRE(parse<json_container>(text) == document);
+}
+
+TEST_CASE("Serializer - round trip", "[serializer][runtime]") {
+  std::string const text =
+      R"({"hosts":[{"name":"localhost","port":8080,"ratio":0.75},{"name":"hé","port":-1}],)"
+      R"("empty":{},"flags":[true,false,null]})";
+  json_container const document = parse<json_container>(text);
+  REQUIRE(parse<json_container>(to_json(document)) == document);
+  REQUIRE(parse<json_container>(to_json(document, 4u)) == document);
+
+  // Nesting depth is only bounded by memory
+  std::size_t const depth = 100000u;
+  std::string const deep = std::string(depth, '[') + "1" + std::string(depth, ']');
+  REQUIRE(to_json(parse<json_container>(deep)) == deep);
+}
@@ -2,6 +2,7 @@
 #include <json_backbone.hpp>
 #include <catch.hpp>
 #include <chrono>
+#include <cstring>
 #include <vector>
 #include <map>
 #include <type_traits>
@@ -24,12 +25,38 @@ using is_the_constructible_t =
 namespace {
 struct not_complete;
 struct complete {};
+
+// Marker selecting the legacy word-wide discriminator
+struct wide_index {};
+struct three_shorts {
+  short a, b, c;
+};
+
+// Marker selecting a 32 bytes inline capacity
+struct wide_buffer {};
+struct three_pointers {
+  void* a;
+  void* b;
+  void* c;
+};
+}
+
+namespace json_backbone {
+template <class... Value>
+struct variant_traits<wide_index, Value...> : default_variant_traits<wide_index, Value...> {
+  using index_type = std::size_t;
+};
+
+template <class... Value>
+struct variant_traits<wide_buffer, Value...> : default_variant_traits<wide_buffer, Value...> {
+  static constexpr std::size_t inline_capacity = 32;
+};
 }
 
 TEST_CASE("Variant - Static invariants", "[variant][static][compile_time]") {
   // Types
   static_assert((std::is_same<typename json_container::object_type,
-                              std::map<std::string, json_container>>::value),
+                              std::map<std::string, json_container, std::less<>>>::value),
                 "Type");
   static_assert(
       (std::is_same<typename json_container::array_type, std::vector<json_container>>::value),
@@ -48,9 +75,9 @@ TEST_CASE("Variant - Static invariants", "[variant][static][compile_time]") {
                 "Inner types indexes");
   static_assert((json_container::target_type_list_t::get_index<std::vector<json_container>>()) == 6,
                 "Inner types indexes");
-  static_assert(
-      (json_container::target_type_list_t::get_index<std::map<std::string, json_container>>()) == 7,
-      "Inner types indexes");
+  static_assert((json_container::target_type_list_t::get_index<
+                    std::map<std::string, json_container, std::less<>>>()) == 7,
+                "Inner types indexes");
   static_assert(json_container::target_type_list_t::get_index<char>() == 8, "Inner types indexes");
 
   // Type from constexpr index
@@ -61,15 +88,14 @@ TEST_CASE("Variant - Static invariants", "[variant][static][compile_time]") {
   static_assert((is_same_at_t<double, 4>::value), "Inner types from indexes");
   static_assert((is_same_at_t<std::string, 5>::value), "Inner types from indexes");
   static_assert((is_same_at_t<std::vector<json_container>, 6>::value), "Inner types from indexes");
-  static_assert((is_same_at_t<std::map<std::string, json_container>, 7>::value),
+  static_assert((is_same_at_t<std::map<std::string, json_container, std::less<>>, 7>::value),
                 "Inner types from indexes");
   static_assert((is_same_at_t<void, 8>::value), "Inner types from indexes");
 
   // has_type
-  static_assert(
-      (json_container::target_type_list_t::has_type<std::map<std::string, json_container>>()) ==
-          true,
-      "Inner types existence");
+  static_assert((json_container::target_type_list_t::has_type<
+                    std::map<std::string, json_container, std::less<>>>()) == true,
+                "Inner types existence");
   static_assert(
       (json_container::target_type_list_t::has_type<std::vector<json_container>>()) == true,
       "Inner types existence");
@@ -108,3 +134,79 @@ TEST_CASE("Variant - Static invariants", "[variant][static][compile_time]") {
 
   REQUIRE(true);
 }
+
+TEST_CASE("Variant - Storage footprint", "[variant][static][compile_time]") {
+  // Discriminator width
+  static_assert(std::is_same<variant<bool, int>::index_type, std::uint8_t>::value, "Index type");
+  static_assert(std::is_same<json_container::index_type, std::uint8_t>::value, "Index type");
+  static_assert(std::is_same<variant<wide_index, int>::index_type, std::size_t>::value,
+                "Index type");
+  static_assert(std::is_same<select_index_type<255>::type, std::uint8_t>::value, "Index type");
+  static_assert(std::is_same<select_index_type<256>::type, std::uint16_t>::value, "Index type");
+
+  // Discriminator stored in the padding of the buffer
+  using small_t = variant<bool, int, float>;
+  using small_wide_t = variant<wide_index, bool, int, float>;
+  using shorts_t = variant<three_shorts, bool>;
+  using shorts_wide_t = variant<wide_index, three_shorts, bool>;
+  static_assert(small_t::alignment == alignof(int), "Alignment");
+  static_assert(shorts_t::alignment == alignof(short), "Alignment");
+  static_assert(sizeof(small_t) == 2 * sizeof(int), "Footprint");
+  static_assert(sizeof(small_wide_t) == 2 * sizeof(std::size_t), "Footprint");
+  static_assert(sizeof(shorts_t) == 4 * sizeof(short), "Footprint");
+
+  // Containers hold a pointer slot without padding, a narrow discriminator does not shrink them
+  using wide_container_t =
+      container<std::map, std::vector, std::string, wide_index, std::nullptr_t, bool,
+                unsigned int, int, double, std::string>;
+  static_assert(sizeof(json_container) == sizeof(wide_container_t), "Footprint");
+
+  static_assert(sizeof(shorts_t) < sizeof(shorts_wide_t), "Footprint");
+
+  REQUIRE(sizeof(small_t) < sizeof(small_wide_t));
+}
+
+TEST_CASE("Variant - Inline capacity footprint", "[variant][static][compile_time]") {
+  using default_t = variant<std::nullptr_t, three_pointers, int>;
+  using wide_t = variant<wide_buffer, three_pointers, int>;
+  static_assert(!default_t::storage_type::is_inline<three_pointers>::value, "Heap");
+  static_assert(wide_t::storage_type::is_inline<three_pointers>::value, "Inline");
+  static_assert(wide_t::memory_size == sizeof(three_pointers), "Footprint");
+  static_assert(wide_t::alignment == alignof(void*), "Alignment");
+
+  static_assert(is_small_type_impl<three_pointers, 24>::value, "Small type");
+  static_assert(!is_small_type_impl<three_pointers, 16>::value, "Small type");
+  static_assert(memory_footprint<three_pointers, 24>::value == sizeof(three_pointers), "Footprint");
+  static_assert(memory_footprint<three_pointers>::value == sizeof(void*), "Footprint");
+  static_assert(store_on_stack<int, sizeof(void*), 32>::value, "Small type");
+
+  // Types wider than the capacity are still allocated
+  using string_t = variant<wide_buffer, std::string, int>;
+  static_assert(string_t::storage_type::is_inline<std::string>::value == (sizeof(std::string) <= 32),
+                "Inline strings");
+
+  REQUIRE(sizeof(default_t) < sizeof(wide_t));
+}
+
+TEST_CASE("Variant - Trivially copyable variants", "[variant][static][compile_time]") {
+  using scalar_t = variant<std::nullptr_t, bool, int, double>;
+  static_assert(std::is_trivially_copyable<scalar_t>::value, "Trivially copyable");
+  static_assert(std::is_trivially_destructible<scalar_t>::value, "Trivially destructible");
+  static_assert(std::is_trivially_copy_constructible<scalar_t>::value, "Trivial copy");
+  static_assert(std::is_trivially_move_assignable<scalar_t>::value, "Trivial move");
+
+  // A single non trivial or heap allocated type is enough to opt out
+  using string_t = variant<std::nullptr_t, int, std::string>;
+  using heap_t = variant<std::nullptr_t, int, three_pointers>;
+  static_assert(!std::is_trivially_copyable<string_t>::value, "Not trivially copyable");
+  static_assert(!std::is_trivially_destructible<heap_t>::value, "Not trivially destructible");
+  static_assert(!std::is_trivially_copyable<json_container>::value, "Not trivially copyable");
+
+  scalar_t values[2] = {scalar_t{1}, scalar_t{2.5}};
+  scalar_t copies[2];
+  std::memcpy(static_cast<void*>(copies), values, sizeof(values));
+  REQUIRE(copies[0].get<int>() == 1);
+  REQUIRE(copies[1].get<double>() == 2.5);
+  copies[0] = copies[1];
+  REQUIRE(copies[0].is<double>());
+}
@@ -0,0 +1,97 @@
+#include <json_backbone.hpp>
+#include <json_backbone/compact_string.hpp>
+#include <catch.hpp>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+using namespace json_backbone;
+
+// Container storing its strings as compact strings
+using compact_container =
+    container<std::map, std::vector, std::string, std::nullptr_t, bool, int, double, compact_string>;
+
+// Resolve CATCH SFINAE trait ambiguity (error on Clang, GCC is fine)
+namespace Catch {
+namespace Detail {
+template <>
+struct IsStreamInsertable<compact_container> {
+  enum { value = false };
+};
+}
+}
+
+TEST_CASE("Strings - compact_string", "[strings][compact][runtime]") {
+  static_assert(sizeof(compact_string) == sizeof(void*), "Compact string is a word");
+  static_assert(store_on_stack<compact_string, sizeof(void*)>::value, "Stored in the variant");
+  static_assert(is_small_type_impl<compact_string16, 2u * sizeof(void*)>::value,
+                "Stored in the variant given a 16 bytes inline capacity");
+  static_assert(std::is_nothrow_move_constructible<compact_string>::value, "Moves are free");
+
+  compact_string const empty;
+  REQUIRE(empty.empty());
+  REQUIRE(empty.stored_inline());
+
+  std::string const short_text(compact_string::inline_capacity, 'a');
+  compact_string const inline_string{short_text};
+  REQUIRE(inline_string.stored_inline());
+  REQUIRE(inline_string == short_text);
+  REQUIRE(inline_string.str() == short_text);
+
+  std::string const long_text = short_text + "b";
+  compact_string heap_string{long_text};
+  REQUIRE(!heap_string.stored_inline());
+  REQUIRE(heap_string == long_text);
+  REQUIRE(inline_string < heap_string);
+  REQUIRE(heap_string != inline_string);
+
+  compact_string copy{heap_string};
+  REQUIRE(copy == heap_string);
+  REQUIRE(copy.data() != heap_string.data());
+  compact_string moved{std::move(copy)};
+  REQUIRE(moved == long_text);
+  REQUIRE(copy.empty());
+  moved = inline_string;
+  REQUIRE(moved.stored_inline());
+  REQUIRE(moved == inline_string);
+
+  compact_string16 const wide{"fifteen chars!!"};
+  REQUIRE(wide.size() == 15u);
+  REQUIRE(wide.stored_inline());
+  REQUIRE(wide == "fifteen chars!!");
+
+  std::ostringstream output;
+  output << compact_string{"abc"} << heap_string;
+  REQUIRE(output.str() == "abc" + long_text);
+  REQUIRE(std::hash<compact_string>{}(heap_string) == string_hash{}(long_text));
+
+  // Null pointers are rejected, nullptr does not convert
+  static_assert(!std::is_convertible<std::nullptr_t, compact_string>::value, "No null string");
+  REQUIRE_THROWS_AS(compact_string{static_cast<char const*>(nullptr)}, std::logic_error);
+}
+
+TEST_CASE("Strings - compact_string in containers", "[strings][compact][container][runtime]") {
+  compact_container c = compact_container::object_type{};
+  c["status"] = "active";
+  c["owner"] = std::string{"Roger the gardener"};
+  c["count"] = 3;
+  REQUIRE(c["status"].is<compact_string>());
+  REQUIRE(c["status"].get<compact_string>().stored_inline());
+  REQUIRE(c["owner"].get<compact_string>() == "Roger the gardener");
+
+  auto v = make_view(c);
+  REQUIRE(v["status"].as<std::string>() == "active");
+  REQUIRE(v["owner"].as<std::string>() == "Roger the gardener");
+  REQUIRE(v["count"].as<std::string>().empty());
+  REQUIRE(v["status"].as<compact_string>() == "active");
+
+  // Null nodes are not convertible to compact strings
+  compact_container const null_node{nullptr};
+  REQUIRE(make_view(null_node).as<compact_string>().empty());
+
+  compact_container copy{c};
+  REQUIRE(copy == c);
+}
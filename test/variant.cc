@@ -4,6 +4,9 @@
 #include <chrono>
 #include <vector>
 #include <map>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
 #include <type_traits>
 
 using namespace json_backbone;
@@ -23,6 +26,43 @@ using is_the_constructible_t =
                  Type>;
 }
 
+// Container stored in a single tagged word
+using packed_container = container<std::map, std::vector, std::string, std::nullptr_t, bool, int,
+                                   unsigned int, double, std::string>;
+
+namespace json_backbone {
+template <class... Others>
+struct variant_traits<std::nullptr_t, bool, int, unsigned int, double, std::string, Others...>
+    : default_variant_traits<std::nullptr_t, bool, int, unsigned int, double, std::string,
+                             Others...> {
+  using layout = pointer_tagged_layout;
+};
+}
+
+// Container stored in a single NaN boxed word
+using boxed_container =
+    container<std::map, std::vector, std::string, std::nullptr_t, bool, double, int, std::string>;
+
+namespace json_backbone {
+template <class... Others>
+struct variant_traits<std::nullptr_t, bool, double, int, std::string, Others...>
+    : default_variant_traits<std::nullptr_t, bool, double, int, std::string, Others...> {
+  using layout = nan_boxed_layout;
+};
+}
+
+// Container storing strings inline
+using inline_string_container =
+    container<std::map, std::vector, std::string, std::nullptr_t, std::string, bool, int, double>;
+
+namespace json_backbone {
+template <class... Others>
+struct variant_traits<std::nullptr_t, std::string, bool, int, double, Others...>
+    : default_variant_traits<std::nullptr_t, std::string, bool, int, double, Others...> {
+  static constexpr std::size_t inline_capacity = sizeof(std::string);
+};
+}
+
 // Resolve CATCH SFINAE trait ambiguity (error on Clang, GCC is fine)
 namespace Catch {
 namespace Detail {
@@ -30,6 +70,18 @@ template <>
 struct IsStreamInsertable<json_container> {
   enum { value = false };
 };
+template <>
+struct IsStreamInsertable<packed_container> {
+  enum { value = false };
+};
+template <>
+struct IsStreamInsertable<boxed_container> {
+  enum { value = false };
+};
+template <>
+struct IsStreamInsertable<inline_string_container> {
+  enum { value = false };
+};
 }
 }
 
@@ -281,3 +333,369 @@ TEST_CASE("Variant - Visit", "[variant][visitor]") {
   REQUIRE(!apply_visitor<bool>(t1, paggregate));
   REQUIRE(apply_visitor<bool>(t2, pcaggregate));
 }
+
+namespace {
+// Distinct types to build long type lists
+template <int N>
+struct numbered {
+  int value;
+  bool operator==(numbered const& other) const { return value == other.value; }
+  bool operator<(numbered const& other) const { return value < other.value; }
+};
+
+struct number_visitor {
+  template <int N>
+  int operator()(numbered<N> const& value) const {
+    return N * 100 + value.value;
+  }
+};
+
+template <class Variant, int... N>
+void check_dispatch(std::integer_sequence<int, N...>) {
+  std::vector<Variant> values{Variant{numbered<N>{N}}...};
+  std::vector<Variant> copies(values);
+  std::vector<Variant> assigned(values.rbegin(), values.rend());
+  for (std::size_t index = 0; index < values.size(); ++index) {
+    int n = static_cast<int>(index);
+    assigned[index] = copies[index];
+    REQUIRE(values[index].type_index() == index);
+    REQUIRE(apply_visitor<int>(values[index], number_visitor{}) == n * 101);
+    REQUIRE(apply_visitor<int>(copies[index], number_visitor{}) == n * 101);
+    REQUIRE(values[index] == assigned[index]);
+    REQUIRE(!(values[index] < assigned[index]));
+    if (0u < index) REQUIRE(values[index - 1u] < values[index]);
+  }
+}
+
+template <int... N>
+using numbered_variant = variant<numbered<N>...>;
+}
+
+TEST_CASE("Variant - Dispatch on long type lists", "[variant][visitor][runtime]") {
+  // Dispatch switches are chained by chunks of 16 types
+  check_dispatch<numbered_variant<0, 1, 2>>(std::make_integer_sequence<int, 3>{});
+  check_dispatch<numbered_variant<0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15>>(
+      std::make_integer_sequence<int, 16>{});
+  check_dispatch<numbered_variant<0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17,
+                                  18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33>>(
+      std::make_integer_sequence<int, 34>{});
+}
+
+TEST_CASE("Variant - Pointer tagged layout", "[variant][layout][runtime]") {
+  static_assert(sizeof(packed_container) == sizeof(void*), "Single word");
+  static_assert(
+      std::is_same<packed_container::layout_type, pointer_tagged_layout>::value, "Layout");
+  static_assert(packed_container::storage_type::is_inline<bool>::value, "Inline");
+  static_assert(packed_container::storage_type::is_inline<int>::value, "Inline");
+  static_assert(packed_container::storage_type::is_inline<std::nullptr_t>::value, "Inline");
+  static_assert(!packed_container::storage_type::is_inline<double>::value, "Heap");
+
+  packed_container c1;
+  packed_container c2{true};
+  packed_container c3{-12};
+  packed_container c4{12u};
+  packed_container c5{1.5};
+  packed_container c6{"Roger"};
+
+  SECTION("Access") {
+    REQUIRE(c1.is<std::nullptr_t>());
+    REQUIRE(c2.is<bool>());
+    REQUIRE(c3.is<int>());
+    REQUIRE(c4.is<unsigned int>());
+    REQUIRE(c5.is<double>());
+    REQUIRE(c6.is<std::string>());
+
+    REQUIRE(c1.get<std::nullptr_t>() == nullptr);
+    REQUIRE(c2.get<bool>());
+    REQUIRE(c3.get<int>() == -12);
+    REQUIRE(raw<unsigned int>(c4) == 12u);
+    REQUIRE(c5.get<double>() == 1.5);
+    REQUIRE(c6.get<std::string>() == "Roger");
+    REQUIRE_THROWS_AS(c3.get<unsigned int>(), bad_variant_access);
+  }
+
+  SECTION("Modification through references keeps the tag") {
+    c3.get<int>() = -1;
+    REQUIRE(c3.is<int>());
+    REQUIRE(c3.get<int>() == -1);
+
+    c1.get<std::nullptr_t>() = nullptr;
+    REQUIRE(c1.is<std::nullptr_t>());
+
+    c2.get<bool>() = false;
+    REQUIRE(c2.is<bool>());
+    REQUIRE(!c2.get<bool>());
+  }
+
+  SECTION("Copy, move and assignation") {
+    packed_container c7{c6};
+    REQUIRE(c7 == c6);
+    packed_container c8{std::move(c7)};
+    REQUIRE(c8.get<std::string>() == "Roger");
+
+    c3 = c6;
+    REQUIRE(c3.get<std::string>() == "Roger");
+    c6 = 4;
+    REQUIRE(c6.get<int>() == 4);
+    c5 = nullptr;
+    REQUIRE(c5.is<std::nullptr_t>());
+    c1 = 2.5;
+    REQUIRE(c1.get<double>() == 2.5);
+    REQUIRE(c2 < c1);
+  }
+
+  SECTION("Nested collections") {
+    packed_container c{packed_container::object_type{}};
+    c["name"] = "Roger";
+    c["children"] = packed_container::array_type{1, true, nullptr, 2.5};
+    REQUIRE(c["name"].get<std::string>() == "Roger");
+    REQUIRE(c["children"].at(0).get<int>() == 1);
+    REQUIRE(c["children"].at(1).get<bool>());
+    REQUIRE(c["children"].at(2).is<std::nullptr_t>());
+    REQUIRE(c["children"].at(3).get<double>() == 2.5);
+
+    auto v = make_view(c);
+    REQUIRE(v["children"][3].as<int>() == 2);
+    std::size_t count = 0;
+    for (auto& element : v["children"]) {
+      (void)element;
+      ++count;
+    }
+    REQUIRE(count == 4);
+  }
+}
+
+TEST_CASE("Variant - NaN boxed layout", "[variant][layout][runtime]") {
+  static_assert(sizeof(boxed_container) == sizeof(double), "Single word");
+  static_assert(boxed_container::storage_type::is_inline<double>::value, "Inline");
+  static_assert(boxed_container::storage_type::is_inline<int>::value, "Inline");
+  static_assert(!boxed_container::storage_type::is_inline<std::string>::value, "Heap");
+
+  boxed_container c1;
+  boxed_container c2{false};
+  boxed_container c3{-3.25};
+  boxed_container c4{-7};
+  boxed_container c5{"Roger"};
+
+  SECTION("Access") {
+    REQUIRE(c1.is<std::nullptr_t>());
+    REQUIRE(c2.is<bool>());
+    REQUIRE(c3.is<double>());
+    REQUIRE(c4.is<int>());
+    REQUIRE(c5.is<std::string>());
+
+    REQUIRE(c1.get<std::nullptr_t>() == nullptr);
+    REQUIRE(!c2.get<bool>());
+    REQUIRE(c3.get<double>() == -3.25);
+    REQUIRE(c4.get<int>() == -7);
+    REQUIRE(c5.get<std::string>() == "Roger");
+  }
+
+  SECTION("Special doubles") {
+    boxed_container inf{-std::numeric_limits<double>::infinity()};
+    REQUIRE(inf.is<double>());
+    REQUIRE(std::isinf(inf.get<double>()));
+
+    // A NaN with a payload colliding with tags is canonicalized
+    std::uint64_t const bits = 0xFFFC000000000001u;
+    double colliding;
+    std::memcpy(&colliding, &bits, sizeof(bits));
+    boxed_container nan{colliding};
+    REQUIRE(nan.is<double>());
+    REQUIRE(std::isnan(nan.get<double>()));
+
+    c4 = std::nan("");
+    REQUIRE(c4.is<double>());
+    REQUIRE(std::isnan(c4.get<double>()));
+
+    // NaN produced by arithmetics keep the type
+    c3.get<double>() = c3.get<double>() * std::numeric_limits<double>::infinity() * 0.0;
+    REQUIRE(c3.is<double>());
+    REQUIRE(std::isnan(c3.get<double>()));
+  }
+
+  SECTION("Copy, move and assignation") {
+    c4.get<int>() = 12;
+    REQUIRE(c4.get<int>() == 12);
+    boxed_container c6{c5};
+    REQUIRE(c6 == c5);
+    c3 = std::move(c6);
+    REQUIRE(c3.get<std::string>() == "Roger");
+    c5 = 1.5;
+    REQUIRE(c5.get<double>() == 1.5);
+    c1 = true;
+    REQUIRE(c1.get<bool>());
+  }
+
+  SECTION("Nested collections") {
+    boxed_container c{boxed_container::array_type{1.5, 2, nullptr, "Roger"}};
+    c.at(0).get<double>() += 1.0;
+    REQUIRE(c.at(0).get<double>() == 2.5);
+    REQUIRE(c.at(1).get<int>() == 2);
+    REQUIRE(c.at(2).is<std::nullptr_t>());
+    REQUIRE(c.at(3).get<std::string>() == "Roger");
+  }
+}
+
+TEST_CASE("Variant - Inline strings", "[variant][layout][runtime]") {
+  static_assert(inline_string_container::storage_type::is_inline<std::string>::value, "Inline");
+  static_assert(inline_string_container::memory_size == sizeof(std::string), "Footprint");
+
+  inline_string_container c1{"Roger"};
+  inline_string_container c2{std::string(64, 'a')};
+  REQUIRE(c1.get<std::string>() == "Roger");
+  REQUIRE(c2.get<std::string>().size() == 64u);
+
+  inline_string_container c3{c1};
+  inline_string_container c4{std::move(c2)};
+  REQUIRE(c3 == c1);
+  REQUIRE(c4.get<std::string>() == std::string(64, 'a'));
+
+  c3 = 1;
+  c1 = c4;
+  REQUIRE(c3.get<int>() == 1);
+  REQUIRE(c1.get<std::string>() == std::string(64, 'a'));
+
+  inline_string_container c{inline_string_container::array_type{"Roger", 1.5, nullptr}};
+  c.at(0).get<std::string>() += " Rabbit";
+  REQUIRE(c.at(0).get<std::string>() == "Roger Rabbit");
+}
+
+namespace {
+struct pair_visitor {
+  std::string operator()(int lhs, int rhs) const { return "ii" + std::to_string(lhs + rhs); }
+  std::string operator()(int, std::string const& rhs) const { return "is" + rhs; }
+  std::string operator()(std::string const& lhs, int) const { return "si" + lhs; }
+  std::string operator()(std::string const& lhs, std::string const& rhs) const {
+    return "ss" + lhs + rhs;
+  }
+};
+
+struct triple_visitor {
+  template <class A, class B, class C>
+  int operator()(A const&, B const&, C const&) const {
+    return 100 * sizeof(A) + 10 * sizeof(B) + sizeof(C);
+  }
+};
+
+struct same_kind_visitor {
+  template <class T>
+  bool operator()(T const&, T const&) const {
+    return true;
+  }
+  template <class T, class U>
+  bool operator()(T const&, U const&) const {
+    return false;
+  }
+};
+}
+
+TEST_CASE("Variant - Multiple visitation", "[variant][visitor][runtime]") {
+  using variant_t = variant<int, std::string>;
+  variant_t i1{1}, i2{2}, s1{std::string{"a"}};
+  variant_t const s2{std::string{"b"}};
+
+  REQUIRE(apply_visitor<std::string>(pair_visitor{}, i1, i2) == "ii3");
+  REQUIRE(apply_visitor<std::string>(pair_visitor{}, i1, s2) == "isb");
+  REQUIRE(apply_visitor<std::string>(pair_visitor{}, s1, i2) == "sia");
+  REQUIRE(apply_visitor<std::string>(pair_visitor{}, s1, s2) == "ssab");
+
+  // Variants of different types and more than two variants
+  variant<char, double, std::int16_t> c{'c'}, d{1.5}, s{std::int16_t{3}};
+  REQUIRE(apply_visitor<int>(triple_visitor{}, c, i1, d) == 148);
+  REQUIRE(apply_visitor<int>(triple_visitor{}, d, s, c) == 821);
+
+  // Containers are visited as variants
+  json_container n1{nullptr}, n2{nullptr}, b{true};
+  REQUIRE(apply_visitor<bool>(same_kind_visitor{}, n1, n2));
+  REQUIRE(!apply_visitor<bool>(same_kind_visitor{}, n1, b));
+  json_container x{2.5};
+  REQUIRE(apply_visitor<int>(triple_visitor{}, n1, b, x) == 818);
+  REQUIRE(apply_visitor<int>(triple_visitor{}, x, x, b) == 881);
+}
+
+namespace {
+// Counts copies and moves
+struct tracked {
+  static int copies;
+  static int moves;
+  std::string name;
+  int value;
+  tracked(std::string n, int v) : name{std::move(n)}, value{v} {}
+  tracked(char const* n) : name{n}, value{0} {}
+  tracked(tracked const& other) : name{other.name}, value{other.value} { ++copies; }
+  tracked(tracked&& other) : name{std::move(other.name)}, value{other.value} { ++moves; }
+  tracked& operator=(tracked const& other) = default;
+  tracked& operator=(tracked&& other) = default;
+  bool operator==(tracked const& other) const { return name == other.name; }
+  bool operator<(tracked const& other) const { return name < other.name; }
+};
+int tracked::copies = 0;
+int tracked::moves = 0;
+}
+
+TEST_CASE("Variant - Emplace", "[variant][construct][runtime]") {
+  using variant_t = variant<int, tracked>;
+  tracked::copies = tracked::moves = 0;
+
+  variant_t v{1};
+  tracked& emplaced = v.emplace<tracked>("emplaced", 3);
+  REQUIRE(v.is<tracked>());
+  REQUIRE(&emplaced == &v.get<tracked>());
+  REQUIRE(emplaced.value == 3);
+  REQUIRE(v.emplace<int>(4) == 4);
+
+  // Converting assignment constructs in place
+  v = "converted";
+  REQUIRE(v.get<tracked>().name == "converted");
+  v = 1;
+  v = "again";
+  REQUIRE(v.get<tracked>().name == "again");
+  REQUIRE(tracked::copies == 0);
+  REQUIRE(tracked::moves == 0);
+
+  // Default construction through emplace
+  variant<int, std::string> s{1};
+  REQUIRE(s.emplace<std::string>().empty());
+  REQUIRE(s.emplace<std::string>(3u, 'x') == "xxx");
+}
+
+namespace {
+// Throws when built from "boom"
+struct throwing_big {
+  std::string name;
+  double padding[4];
+  throwing_big(char const* n) : name{n} {
+    if (name == "boom") throw std::runtime_error{"boom"};
+  }
+};
+
+struct throwing_small {
+  int value;
+  throwing_small(int v) : value{v} {
+    if (v < 0) throw std::runtime_error{"negative"};
+  }
+};
+}
+
+TEST_CASE("Variant - Emplace with throwing constructors", "[variant][construct][runtime]") {
+  // Heap allocated values
+  variant<std::nullptr_t, throwing_big, std::string> v{std::string{"kept"}};
+  REQUIRE_THROWS_AS(v = "boom", std::runtime_error);
+  REQUIRE(v.get<std::string>() == "kept");
+  v = "built";
+  REQUIRE(v.get<throwing_big>().name == "built");
+  REQUIRE_THROWS_AS(v = "boom", std::runtime_error);
+  REQUIRE(v.get<throwing_big>().name == "built");
+  REQUIRE_THROWS_AS(v.emplace<throwing_big>("boom"), std::runtime_error);
+  REQUIRE(v.get<throwing_big>().name == "built");
+
+  // Values stored in the variant
+  static_assert(store_on_stack<throwing_small, sizeof(void*)>::value, "Stored in the variant");
+  variant<std::nullptr_t, throwing_small, std::string> s{std::string{"kept"}};
+  REQUIRE_THROWS_AS(s.emplace<throwing_small>(-1), std::runtime_error);
+  REQUIRE(s.get<std::string>() == "kept");
+  REQUIRE(s.emplace<throwing_small>(1).value == 1);
+  REQUIRE_THROWS_AS(s.emplace<throwing_small>(-1), std::runtime_error);
+  REQUIRE(s.get<throwing_small>().value == 1);
+}
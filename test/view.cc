@@ -1,11 +1,36 @@
 #include <json_backbone.hpp>
+#include <json_backbone/path.hpp>
+#include <json_backbone/symbol.hpp>
 #include <catch.hpp>
+#include <atomic>
 #include <chrono>
+#include <cstdlib>
 #include <list>
 #include <vector>
 #include <map>
+#include <new>
 #include <type_traits>
 
+// Counts the allocations of the whole test program
+namespace {
+std::atomic<std::size_t> allocations{0u};
+}
+
+void* operator new(std::size_t size) {
+  allocations.fetch_add(1u, std::memory_order_relaxed);
+  if (void* memory = std::malloc(size ? size : 1u)) return memory;
+  throw std::bad_alloc{};
+}
+
+void* operator new(std::size_t size, std::nothrow_t const&) noexcept {
+  allocations.fetch_add(1u, std::memory_order_relaxed);
+  return std::malloc(size ? size : 1u);
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete(void* memory, std::nothrow_t const&) noexcept { std::free(memory); }
+
 // using json_container = json_bac
 using namespace json_backbone;
 
@@ -136,3 +161,86 @@ TEST_CASE("View - access", "[view][access][runtime]") {
     CHECK(begin == view_iterator<view<json_container>>());
   }
 }
+
+TEST_CASE("View - lookups without allocation", "[view][access][transparent][runtime]") {
+  // Keys longer than any small string buffer
+  char const long_key[] = "a key much longer than the small string buffers";
+  char const missing_key[] = "a missing key much longer than the small string buffers";
+  json_container c = json_container::object_type{};
+  c[std::string{long_key}] = 1;
+  c["name"] = "Roger";
+  json_container const& const_c = c;
+  auto v = make_view(c);
+  static_assert(has_transparent_lookup<json_container::object_type>::value, "Transparent");
+
+  std::size_t const before = allocations.load();
+  json_container const* found = &const_c[long_key];
+  auto const found_view = v[long_key];
+  auto const missing_view = v[missing_key];
+  auto const short_view = v["name"];
+  std::size_t const after = allocations.load();
+
+  REQUIRE(after == before);
+  REQUIRE(found->get<int>() == 1);
+  REQUIRE(found_view.get<int>() == 1);
+  REQUIRE(missing_view.empty());
+  REQUIRE(short_view.get<std::string>() == "Roger");
+
+  // Symbol keys are found in their table without building strings
+  using symbol_container =
+      container<std::map, std::vector, symbol, std::nullptr_t, bool, int, double, std::string>;
+  symbol_table table;
+  default_symbol_table_guard guard{table};
+  symbol_container s = symbol_container::object_type{};
+  s[symbol{long_key}] = 1;
+  symbol_container const& const_s = s;
+  auto sv = make_view(s);
+
+  std::size_t const symbols_before = allocations.load();
+  symbol_container const* found_symbol = &const_s[long_key];
+  auto const missing_symbol = sv[missing_key];
+  symbol const interned{long_key};
+  std::size_t const symbols_after = allocations.load();
+
+  REQUIRE(symbols_after == symbols_before);
+  REQUIRE(found_symbol->get<int>() == 1);
+  REQUIRE(missing_symbol.empty());
+  REQUIRE(interned == symbol(table, long_key));
+  REQUIRE(table.size() == 1u);
+}
+
+TEST_CASE("View - compiled path", "[view][path][runtime]") {
+  auto c = make_object({
+      "name"_a = "Roger",  //
+      "children"_a = make_array({make_object({"name"_a = "Martha", "age"_a = 6}),
+                                 make_object({"name"_a = "Jesabelle", "age"_a = 2})}),
+      "a/b~c"_a = 1,  //
+      "0"_a = 2       //
+  });
+
+  path<json_container> const pointer{"/children/1/name"};
+  REQUIRE(pointer.size() == 3u);
+  REQUIRE(pointer(c).get<std::string>() == "Jesabelle");
+  REQUIRE(pointer(c).key() == "name");
+  REQUIRE(path<json_container>{}["children"][0]["age"](c).get<int>() == 6);
+  REQUIRE(path<json_container>{"/a~1b~0c"}(c).get<int>() == 1);
+  REQUIRE(path<json_container>{"/0"}(c).get<int>() == 2);  // Numeric segments are keys in objects
+  REQUIRE(path<json_container>{""}(c).is<json_container::object_type>());
+
+  // Resolution from a view
+  auto children = make_view(c)["children"];
+  REQUIRE(path<json_container>{"/0/name"}(children).get<std::string>() == "Martha");
+
+  // Misses give empty views
+  REQUIRE(path<json_container>{"/children/2/name"}(c).empty());
+  REQUIRE(path<json_container>{"/children/name"}(c).empty());
+  REQUIRE(path<json_container>{}["name"][0](c).empty());
+  REQUIRE(path<json_container>{"/missing"}(c).empty());
+  REQUIRE(path<json_container>{"/children/18446744073709551617"}(c).empty());  // 2^64 + 1
+  REQUIRE(path<json_container>{"/children/340282366920938463463374607431768211457"}(c).empty());
+  REQUIRE(pointer(make_view(c)["missing"]).empty());
+
+  REQUIRE_THROWS_AS(path<json_container>{"name"}, bad_path);
+  REQUIRE_THROWS_AS(path<json_container>{"/a~2"}, bad_path);
+  REQUIRE_THROWS_AS(path<json_container>{"/a~"}, bad_path);
+}